@@ -29,6 +29,13 @@ class Eci
 {
 public:
 
+    /**
+     * Initialise to the default date with a zero position and velocity
+     */
+    Eci()
+    {
+    }
+
     /**
      * @param[in] dt the date to be used for this position
      * @param[in] latitude the latitude in degrees
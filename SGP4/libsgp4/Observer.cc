@@ -80,3 +80,24 @@ CoordTopocentric Observer::GetLookAngle(const Eci &eci)
             range.w,
             rate);
 }
+
+/*
+ * calculate only the elevation between the observer and the passed in Eci
+ * object
+ */
+double Observer::GetElevation(const Eci &eci)
+{
+    Update(eci.GetDateTime());
+
+    Vector range = eci.Position() - m_eci.Position();
+
+    double theta = eci.GetDateTime().ToLocalMeanSiderealTime(m_geo.longitude);
+
+    double sin_lat = sin(m_geo.latitude);
+    double cos_lat = cos(m_geo.latitude);
+
+    double top_z = cos_lat * cos(theta) * range.x
+        + cos_lat * sin(theta) * range.y + sin_lat * range.z;
+
+    return asin(top_z / range.Magnitude());
+}
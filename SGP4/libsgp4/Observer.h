@@ -80,6 +80,14 @@ public:
      */
     CoordTopocentric GetLookAngle(const Eci &eci);
 
+    /**
+     * Get only the elevation of the object, skipping the azimuth and
+     * range rate, for coarse visibility screening
+     * @param[in] eci the object to find the elevation of
+     * @returns the elevation in radians
+     */
+    double GetElevation(const Eci &eci);
+
 private:
     /**
      * @param[in] dt the date to update the observers position for
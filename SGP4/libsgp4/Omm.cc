@@ -0,0 +1 @@
+#include "Omm.h"
@@ -0,0 +1,237 @@
+/*
+ * Copyright 2013 Daniel Warner <contact@danrw.com>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef OMM_H_
+#define OMM_H_
+
+#include "Util.h"
+#include "DateTime.h"
+
+#include <string>
+
+/**
+ * @brief The mean elements of a single CCSDS Orbit Mean-elements Message.
+ *
+ * Holds one record as decoded by OmmReader. Unlike a Tle the values are
+ * stored as parsed, so the norad number is not limited to five digits.
+ */
+class Omm
+{
+public:
+    Omm()
+        : mean_motion_dt2_(0.0)
+        , mean_motion_ddt6_(0.0)
+        , bstar_(0.0)
+        , inclination_(0.0)
+        , right_ascending_node_(0.0)
+        , eccentricity_(0.0)
+        , argument_perigee_(0.0)
+        , mean_anomaly_(0.0)
+        , mean_motion_(0.0)
+        , norad_number_(0)
+        , orbit_number_(0)
+        , element_number_(0)
+    {
+    }
+
+    /**
+     * Get the satellite name
+     * @returns the satellite name
+     */
+    std::string Name() const
+    {
+        return name_;
+    }
+
+    /**
+     * Get the international designator (OBJECT_ID)
+     * @returns the international designator
+     */
+    std::string IntDesignator() const
+    {
+        return int_designator_;
+    }
+
+    /**
+     * Get the norad number
+     * @returns the norad number
+     */
+    unsigned int NoradNumber() const
+    {
+        return norad_number_;
+    }
+
+    /**
+     * Get the element set epoch
+     * @returns the element set epoch
+     */
+    DateTime Epoch() const
+    {
+        return epoch_;
+    }
+
+    /**
+     * Get the first time derivative of the mean motion divided by two
+     * @returns the first time derivative of the mean motion divided by two
+     */
+    double MeanMotionDt2() const
+    {
+        return mean_motion_dt2_;
+    }
+
+    /**
+     * Get the second time derivative of mean motion divided by six
+     * @returns the second time derivative of mean motion divided by six
+     */
+    double MeanMotionDdt6() const
+    {
+        return mean_motion_ddt6_;
+    }
+
+    /**
+     * Get the BSTAR drag term
+     * @returns the BSTAR drag term
+     */
+    double BStar() const
+    {
+        return bstar_;
+    }
+
+    /**
+     * Get the inclination
+     * @param in_degrees Whether to return the value in degrees or radians
+     * @returns the inclination
+     */
+    double Inclination(bool in_degrees) const
+    {
+        if (in_degrees)
+        {
+            return inclination_;
+        }
+        else
+        {
+            return Util::DegreesToRadians(inclination_);
+        }
+    }
+
+    /**
+     * Get the right ascension of the ascending node
+     * @param in_degrees Whether to return the value in degrees or radians
+     * @returns the right ascension of the ascending node
+     */
+    double RightAscendingNode(const bool in_degrees) const
+    {
+        if (in_degrees)
+        {
+            return right_ascending_node_;
+        }
+        else
+        {
+            return Util::DegreesToRadians(right_ascending_node_);
+        }
+    }
+
+    /**
+     * Get the eccentricity
+     * @returns the eccentricity
+     */
+    double Eccentricity() const
+    {
+        return eccentricity_;
+    }
+
+    /**
+     * Get the argument of perigee
+     * @param in_degrees Whether to return the value in degrees or radians
+     * @returns the argument of perigee
+     */
+    double ArgumentPerigee(const bool in_degrees) const
+    {
+        if (in_degrees)
+        {
+            return argument_perigee_;
+        }
+        else
+        {
+            return Util::DegreesToRadians(argument_perigee_);
+        }
+    }
+
+    /**
+     * Get the mean anomaly
+     * @param in_degrees Whether to return the value in degrees or radians
+     * @returns the mean anomaly
+     */
+    double MeanAnomaly(const bool in_degrees) const
+    {
+        if (in_degrees)
+        {
+            return mean_anomaly_;
+        }
+        else
+        {
+            return Util::DegreesToRadians(mean_anomaly_);
+        }
+    }
+
+    /**
+     * Get the mean motion
+     * @returns the mean motion (revolutions per day)
+     */
+    double MeanMotion() const
+    {
+        return mean_motion_;
+    }
+
+    /**
+     * Get the orbit number (REV_AT_EPOCH)
+     * @returns the orbit number
+     */
+    unsigned int OrbitNumber() const
+    {
+        return orbit_number_;
+    }
+
+    /**
+     * Get the element set number
+     * @returns the element set number
+     */
+    unsigned int ElementNumber() const
+    {
+        return element_number_;
+    }
+
+private:
+    friend class OmmReader;
+
+    std::string name_;
+    std::string int_designator_;
+    DateTime epoch_;
+    double mean_motion_dt2_;
+    double mean_motion_ddt6_;
+    double bstar_;
+    double inclination_;
+    double right_ascending_node_;
+    double eccentricity_;
+    double argument_perigee_;
+    double mean_anomaly_;
+    double mean_motion_;
+    unsigned int norad_number_;
+    unsigned int orbit_number_;
+    unsigned int element_number_;
+};
+
+#endif
@@ -0,0 +1 @@
+#include "OmmException.h"
@@ -0,0 +1,41 @@
+/*
+ * Copyright 2013 Daniel Warner <contact@danrw.com>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef OMMEXCEPTION_H_
+#define OMMEXCEPTION_H_
+
+#include <stdexcept>
+#include <string>
+
+/**
+ * @brief The exception that the OmmReader class throws on an error.
+ *
+ * The exception that the OMM decoder will throw on a malformed record.
+ */
+class OmmException : public std::runtime_error
+{
+public:
+    /**
+     * Constructor
+     * @param message Exception message
+     */
+    OmmException(const char* message)
+        : runtime_error(message)
+    {
+    }
+};
+
+#endif
@@ -0,0 +1,505 @@
+/*
+ * Copyright 2013 Daniel Warner <contact@danrw.com>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "OmmReader.h"
+
+#include <cstdlib>
+#include <cstring>
+
+namespace
+{
+    enum OmmField
+    {
+        OMM_OBJECT_NAME,
+        OMM_OBJECT_ID,
+        OMM_EPOCH,
+        OMM_MEAN_MOTION,
+        OMM_ECCENTRICITY,
+        OMM_INCLINATION,
+        OMM_RA_OF_ASC_NODE,
+        OMM_ARG_OF_PERICENTER,
+        OMM_MEAN_ANOMALY,
+        OMM_NORAD_CAT_ID,
+        OMM_ELEMENT_SET_NO,
+        OMM_REV_AT_EPOCH,
+        OMM_BSTAR,
+        OMM_MEAN_MOTION_DOT,
+        OMM_MEAN_MOTION_DDOT,
+        OMM_MEAN_ELEMENT_THEORY,
+        OMM_CCSDS_OMM_VERS,
+        OMM_NUM_FIELDS
+    };
+
+    static const char* const OMM_KEYS[OMM_NUM_FIELDS] = {
+        "OBJECT_NAME",
+        "OBJECT_ID",
+        "EPOCH",
+        "MEAN_MOTION",
+        "ECCENTRICITY",
+        "INCLINATION",
+        "RA_OF_ASC_NODE",
+        "ARG_OF_PERICENTER",
+        "MEAN_ANOMALY",
+        "NORAD_CAT_ID",
+        "ELEMENT_SET_NO",
+        "REV_AT_EPOCH",
+        "BSTAR",
+        "MEAN_MOTION_DOT",
+        "MEAN_MOTION_DDOT",
+        "MEAN_ELEMENT_THEORY",
+        "CCSDS_OMM_VERS"
+    };
+
+    /*
+     * fields without which the elements cannot be propagated
+     */
+    static const unsigned int OMM_REQUIRED =
+        (1u << OMM_EPOCH)
+        | (1u << OMM_MEAN_MOTION)
+        | (1u << OMM_ECCENTRICITY)
+        | (1u << OMM_INCLINATION)
+        | (1u << OMM_RA_OF_ASC_NODE)
+        | (1u << OMM_ARG_OF_PERICENTER)
+        | (1u << OMM_MEAN_ANOMALY)
+        | (1u << OMM_NORAD_CAT_ID);
+
+    char* Trim(char* begin)
+    {
+        while (*begin == ' ' || *begin == '\t')
+        {
+            begin++;
+        }
+        char* end = begin + strlen(begin);
+        while (end > begin && (end[-1] == ' ' || end[-1] == '\t'
+                    || end[-1] == '\r' || end[-1] == '\n'))
+        {
+            end--;
+        }
+        *end = '\0';
+        return begin;
+    }
+
+    /*
+     * parse exactly count digits, returns -1 on a non-digit
+     */
+    int ParseDigits(const char*& str, int count)
+    {
+        int val = 0;
+        for (int i = 0; i < count; i++, str++)
+        {
+            if (*str < '0' || *str > '9')
+            {
+                return -1;
+            }
+            val = val * 10 + (*str - '0');
+        }
+        return val;
+    }
+
+    double ParseDouble(const char* str)
+    {
+        char* end;
+        const double val = strtod(str, &end);
+        if (end == str)
+        {
+            throw OmmException("Invalid numeric field");
+        }
+        return val;
+    }
+
+    unsigned int ParseUnsigned(const char* str)
+    {
+        char* end;
+        const unsigned long val = strtoul(str, &end, 10);
+        if (end == str)
+        {
+            throw OmmException("Invalid integer field");
+        }
+        return static_cast<unsigned int>(val);
+    }
+}
+
+bool OmmReader::Next(Omm& omm)
+{
+    if (format_ == FORMAT_UNKNOWN)
+    {
+        DetectFormat();
+    }
+
+    if (format_ == FORMAT_CSV)
+    {
+        return NextCsv(omm);
+    }
+    else if (format_ == FORMAT_KVN)
+    {
+        return NextKvn(omm);
+    }
+
+    return false;
+}
+
+bool OmmReader::ReadLine()
+{
+    if (have_line_)
+    {
+        have_line_ = false;
+        return true;
+    }
+
+    if (!std::getline(stream_, line_))
+    {
+        return false;
+    }
+    line_number_++;
+
+    return true;
+}
+
+/**
+ * Determine the encoding from the first non-blank line. A csv header is
+ * consumed here, a kvn line is left for NextKvn().
+ * @exception OmmException
+ */
+void OmmReader::DetectFormat()
+{
+    while (ReadLine())
+    {
+        char* str = Trim(&line_[0]);
+        if (*str == '\0')
+        {
+            continue;
+        }
+
+        if (*str == '<')
+        {
+            format_ = FORMAT_UNSUPPORTED;
+            throw OmmException("XML encoded OMM is not supported");
+        }
+
+        if (strchr(str, '=') != NULL)
+        {
+            format_ = FORMAT_KVN;
+            have_line_ = true;
+            return;
+        }
+
+        /*
+         * csv header, map each column to a field
+         */
+        format_ = FORMAT_CSV;
+        columns_.clear();
+        char* token = str;
+        for (;;)
+        {
+            char* comma = strchr(token, ',');
+            if (comma != NULL)
+            {
+                *comma = '\0';
+            }
+            columns_.push_back(LookupField(Trim(token)));
+            if (comma == NULL)
+            {
+                break;
+            }
+            token = comma + 1;
+        }
+        return;
+    }
+}
+
+bool OmmReader::NextCsv(Omm& omm)
+{
+    while (ReadLine())
+    {
+        char* str = &line_[0];
+        if (Trim(str)[0] == '\0')
+        {
+            continue;
+        }
+
+        omm = Omm();
+        fields_ = 0;
+
+        /*
+         * split in place, honouring quoted fields
+         */
+        size_t column = 0;
+        char* token = str;
+        bool last = false;
+        while (!last && column < columns_.size())
+        {
+            char* end = token;
+            if (*end == '"')
+            {
+                token = ++end;
+                while (*end != '\0' && *end != '"')
+                {
+                    end++;
+                }
+                if (*end == '"')
+                {
+                    *end++ = '\0';
+                }
+            }
+            while (*end != '\0' && *end != ',')
+            {
+                end++;
+            }
+            last = (*end == '\0');
+            *end = '\0';
+
+            if (columns_[column] >= 0)
+            {
+                SetField(omm, columns_[column], Trim(token));
+            }
+
+            token = end + 1;
+            column++;
+        }
+
+        if (!Finish())
+        {
+            throw OmmException("Missing required field in csv record");
+        }
+        return true;
+    }
+
+    return false;
+}
+
+bool OmmReader::NextKvn(Omm& omm)
+{
+    omm = Omm();
+    fields_ = 0;
+
+    while (ReadLine())
+    {
+        char* str = Trim(&line_[0]);
+        char* equals = strchr(str, '=');
+        if (equals == NULL)
+        {
+            /*
+             * blank lines, COMMENT lines and block markers
+             */
+            continue;
+        }
+        *equals = '\0';
+
+        const int field = LookupField(Trim(str));
+        if (field == OMM_CCSDS_OMM_VERS)
+        {
+            if (fields_ != 0)
+            {
+                /*
+                 * start of the next record, keep the line for later
+                 */
+                *equals = '=';
+                have_line_ = true;
+                break;
+            }
+            continue;
+        }
+
+        if (field >= 0)
+        {
+            SetField(omm, field, Trim(equals + 1));
+        }
+    }
+
+    if (fields_ == 0)
+    {
+        return false;
+    }
+
+    if (!Finish())
+    {
+        throw OmmException("Missing required field in kvn record");
+    }
+    return true;
+}
+
+/**
+ * Store a single decoded value.
+ * @exception OmmException
+ */
+void OmmReader::SetField(Omm& omm, int field, char* value)
+{
+    if (*value == '\0')
+    {
+        return;
+    }
+
+    switch (field)
+    {
+    case OMM_OBJECT_NAME:
+        omm.name_ = value;
+        break;
+    case OMM_OBJECT_ID:
+        omm.int_designator_ = value;
+        break;
+    case OMM_EPOCH:
+        omm.epoch_ = ParseEpoch(value);
+        break;
+    case OMM_MEAN_MOTION:
+        omm.mean_motion_ = ParseDouble(value);
+        break;
+    case OMM_ECCENTRICITY:
+        omm.eccentricity_ = ParseDouble(value);
+        break;
+    case OMM_INCLINATION:
+        omm.inclination_ = ParseDouble(value);
+        break;
+    case OMM_RA_OF_ASC_NODE:
+        omm.right_ascending_node_ = ParseDouble(value);
+        break;
+    case OMM_ARG_OF_PERICENTER:
+        omm.argument_perigee_ = ParseDouble(value);
+        break;
+    case OMM_MEAN_ANOMALY:
+        omm.mean_anomaly_ = ParseDouble(value);
+        break;
+    case OMM_NORAD_CAT_ID:
+        omm.norad_number_ = ParseUnsigned(value);
+        break;
+    case OMM_ELEMENT_SET_NO:
+        omm.element_number_ = ParseUnsigned(value);
+        break;
+    case OMM_REV_AT_EPOCH:
+        omm.orbit_number_ = ParseUnsigned(value);
+        break;
+    case OMM_BSTAR:
+        omm.bstar_ = ParseDouble(value);
+        break;
+    case OMM_MEAN_MOTION_DOT:
+        omm.mean_motion_dt2_ = ParseDouble(value);
+        break;
+    case OMM_MEAN_MOTION_DDOT:
+        omm.mean_motion_ddt6_ = ParseDouble(value);
+        break;
+    case OMM_MEAN_ELEMENT_THEORY:
+        /*
+         * only sgp4 mean elements may be fed to the propagator
+         */
+        if (strstr(value, "SGP4") == NULL)
+        {
+            throw OmmException("Mean element theory is not SGP4");
+        }
+        break;
+    default:
+        return;
+    }
+
+    fields_ |= 1u << field;
+}
+
+bool OmmReader::Finish()
+{
+    return (fields_ & OMM_REQUIRED) == OMM_REQUIRED;
+}
+
+int OmmReader::LookupField(const char* key)
+{
+    for (int i = 0; i < OMM_NUM_FIELDS; i++)
+    {
+        if (strcmp(key, OMM_KEYS[i]) == 0)
+        {
+            return i;
+        }
+    }
+
+    return -1;
+}
+
+/**
+ * Parse an epoch of the form YYYY-MM-DDThh:mm:ss[.ffffff] or
+ * YYYY-DDDThh:mm:ss[.ffffff]
+ * @exception OmmException
+ */
+DateTime OmmReader::ParseEpoch(const char* str)
+{
+    const int year = ParseDigits(str, 4);
+    if (!DateTime::IsValidYear(year) || *str++ != '-')
+    {
+        throw OmmException("Invalid epoch");
+    }
+
+    DateTime date;
+    const char* mark = str;
+    const int month = ParseDigits(str, 2);
+    if (*str == '-')
+    {
+        str++;
+        const int day = ParseDigits(str, 2);
+        if (!DateTime::IsValidYearMonthDay(year, month, day))
+        {
+            throw OmmException("Invalid epoch");
+        }
+        date = DateTime(year, month, day);
+    }
+    else
+    {
+        /*
+         * day of year form
+         */
+        str = mark;
+        const int doy = ParseDigits(str, 3);
+        if (doy < 1 || doy > (DateTime::IsLeapYear(year) ? 366 : 365))
+        {
+            throw OmmException("Invalid epoch");
+        }
+        date = DateTime(static_cast<unsigned int>(year), doy);
+    }
+
+    if (*str++ != 'T')
+    {
+        throw OmmException("Invalid epoch");
+    }
+
+    /*
+     * test each separator before stepping over it, so a truncated epoch
+     * stops at the terminating nul
+     */
+    const int hour = ParseDigits(str, 2);
+    if (*str != ':')
+    {
+        throw OmmException("Invalid epoch");
+    }
+    str++;
+    const int minute = ParseDigits(str, 2);
+    if (*str != ':')
+    {
+        throw OmmException("Invalid epoch");
+    }
+    str++;
+    const int second = ParseDigits(str, 2);
+    if (hour < 0 || hour > 23 || minute < 0 || minute > 59
+            || second < 0 || second > 59)
+    {
+        throw OmmException("Invalid epoch");
+    }
+
+    int microsecond = 0;
+    if (*str == '.')
+    {
+        str++;
+        for (int scale = 100000; *str >= '0' && *str <= '9'; scale /= 10)
+        {
+            microsecond += (*str++ - '0') * scale;
+        }
+    }
+
+    return date.Add(TimeSpan(0, hour, minute, second, microsecond));
+}
@@ -0,0 +1,100 @@
+/*
+ * Copyright 2013 Daniel Warner <contact@danrw.com>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef OMMREADER_H_
+#define OMMREADER_H_
+
+#include "Omm.h"
+#include "OmmException.h"
+
+#include <istream>
+#include <string>
+#include <vector>
+
+/**
+ * @brief Streams Omm records out of a CSV or KVN encoded OMM catalog.
+ *
+ * The encoding is detected from the first line of the stream. Records are
+ * decoded one at a time straight from the line buffer, so a full catalog can
+ * be ingested without building intermediate Tle strings.
+ */
+class OmmReader
+{
+public:
+    /**
+     * @details Initialise given the stream holding the catalog
+     * @param[in] stream the OMM catalog, CSV or KVN encoded
+     */
+    OmmReader(std::istream& stream)
+        : stream_(stream)
+        , format_(FORMAT_UNKNOWN)
+        , line_number_(0)
+        , have_line_(false)
+        , fields_(0)
+    {
+    }
+
+    /**
+     * Decode the next record from the stream
+     * @param[out] omm the decoded record
+     * @returns false once the stream holds no further records
+     * @exception OmmException
+     */
+    bool Next(Omm& omm);
+
+    /**
+     * Get the line the reader has reached, for error reporting
+     * @returns the current line number
+     */
+    unsigned long LineNumber() const
+    {
+        return line_number_;
+    }
+
+private:
+    enum Format
+    {
+        FORMAT_UNKNOWN,
+        FORMAT_CSV,
+        FORMAT_KVN,
+        FORMAT_UNSUPPORTED
+    };
+
+    bool ReadLine();
+    void DetectFormat();
+    bool NextCsv(Omm& omm);
+    bool NextKvn(Omm& omm);
+    void SetField(Omm& omm, int field, char* value);
+    bool Finish();
+    static int LookupField(const char* key);
+    static DateTime ParseEpoch(const char* str);
+
+    std::istream& stream_;
+    Format format_;
+    unsigned long line_number_;
+    bool have_line_;
+    std::string line_;
+    /*
+     * field id of each csv column
+     */
+    std::vector<int> columns_;
+    /*
+     * bitmask of the fields seen in the current record
+     */
+    unsigned int fields_;
+};
+
+#endif
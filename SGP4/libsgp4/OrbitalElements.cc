@@ -18,6 +18,7 @@
 #include "OrbitalElements.h"
 
 #include "Tle.h"
+#include "Omm.h"
 
 OrbitalElements::OrbitalElements(const Tle& tle)
 {
@@ -33,6 +34,28 @@ OrbitalElements::OrbitalElements(const Tle& tle)
     bstar_ = tle.BStar();
     epoch_ = tle.Epoch();
 
+    RecoverElements();
+}
+
+OrbitalElements::OrbitalElements(const Omm& omm)
+{
+    /*
+     * take the mean elements straight from the omm record
+     */
+    mean_anomoly_ = omm.MeanAnomaly(false);
+    ascending_node_ = omm.RightAscendingNode(false);
+    argument_perigee_ = omm.ArgumentPerigee(false);
+    eccentricity_ = omm.Eccentricity();
+    inclination_ = omm.Inclination(false);
+    mean_motion_ = omm.MeanMotion() * kTWOPI / kMINUTES_PER_DAY;
+    bstar_ = omm.BStar();
+    epoch_ = omm.Epoch();
+
+    RecoverElements();
+}
+
+void OrbitalElements::RecoverElements()
+{
     /*
      * recover original mean motion (xnodp) and semimajor axis (aodp)
      * from input elements
@@ -36,6 +36,13 @@ void SGP4::SetTle(const Tle& tle)
     Initialise();
 }
 
+void SGP4::SetElements(const OrbitalElements& elements)
+{
+    elements_ = elements;
+
+    Initialise();
+}
+
 void SGP4::Initialise()
 {
     /*
@@ -214,18 +221,84 @@ Eci SGP4::FindPosition(const DateTime& dt) const
 }
 
 Eci SGP4::FindPosition(double tsince) const
+{
+    Eci eci;
+    const Status status = FindPosition(tsince, eci);
+
+    if (status == DECAYED)
+    {
+        throw DecayedException(
+                eci.GetDateTime(),
+                eci.Position(),
+                eci.Velocity());
+    }
+    else if (status != OK)
+    {
+        throw SatelliteException(StatusMessage(status));
+    }
+
+    return eci;
+}
+
+SGP4::Status SGP4::FindPosition(const DateTime& dt, Eci& eci) const noexcept
+{
+    return FindPosition((dt - elements_.Epoch()).TotalMinutes(), eci);
+}
+
+SGP4::Status SGP4::FindPosition(double tsince, Eci& eci) const noexcept
+{
+    if (use_deep_space_)
+    {
+        return FindPositionSDP4(tsince, true, eci);
+    }
+    else
+    {
+        return FindPositionSGP4(tsince, true, eci);
+    }
+}
+
+SGP4::Status SGP4::FindPositionOnly(const DateTime& dt, Eci& eci) const noexcept
+{
+    return FindPositionOnly((dt - elements_.Epoch()).TotalMinutes(), eci);
+}
+
+SGP4::Status SGP4::FindPositionOnly(double tsince, Eci& eci) const noexcept
 {
     if (use_deep_space_)
     {
-        return FindPositionSDP4(tsince);
+        return FindPositionSDP4(tsince, false, eci);
     }
     else
     {
-        return FindPositionSGP4(tsince);
+        return FindPositionSGP4(tsince, false, eci);
     }
 }
 
-Eci SGP4::FindPositionSDP4(double tsince) const
+const char* SGP4::StatusMessage(Status status)
+{
+    switch (status)
+    {
+    case OK:
+        return "Ok";
+    case DECAYED:
+        return "Satellite decayed";
+    case INVALID_ECCENTRICITY:
+        return "Error: (e <= -0.001)";
+    case INVALID_MEAN_MOTION:
+        return "Error: (xn <= 0.0)";
+    case INVALID_LONG_PERIOD_ECCENTRICITY:
+        return "Error: (elsq >= 1.0)";
+    case INVALID_SEMI_LATUS_RECTUM:
+        return "Error: (pl < 0.0)";
+    }
+
+    return "Unknown status";
+}
+
+SGP4::Status SGP4::FindPositionSDP4(
+        double tsince,
+        const bool with_velocity,
+        Eci& eci) const noexcept
 {
     /*
      * the final values
@@ -271,7 +344,7 @@ Eci SGP4::FindPositionSDP4(double tsince) const
 
     if (xn <= 0.0)
     {
-        throw SatelliteException("Error: (xn <= 0.0)");
+        return INVALID_MEAN_MOTION;
     }
 
     a = pow(kXKE / xn, kTWOTHIRD) * tempa * tempa;
@@ -305,7 +378,7 @@ Eci SGP4::FindPositionSDP4(double tsince) const
      */
     if (e <= -0.001)
     {
-        throw SatelliteException("Error: (e <= -0.001)");
+        return INVALID_ECCENTRICITY;
     }
     else if (e < 1.0e-6)
     {
@@ -351,7 +424,9 @@ Eci SGP4::FindPositionSDP4(double tsince) const
                                           perturbed_x1mth2,
                                           perturbed_x7thm1,
                                           perturbed_cosio,
-                                          perturbed_sinio);
+                                          perturbed_sinio,
+                                          with_velocity,
+                                          eci);
 }
 
 void SGP4::RecomputeConstants(const double xinc,
@@ -384,7 +459,10 @@ void SGP4::RecomputeConstants(const double xinc,
     aycof = 0.25 * kA3OVK2 * sinio;
 }
 
-Eci SGP4::FindPositionSGP4(double tsince) const
+SGP4::Status SGP4::FindPositionSGP4(
+        double tsince,
+        const bool with_velocity,
+        Eci& eci) const noexcept
 {
     /*
      * the final values
@@ -446,7 +524,7 @@ Eci SGP4::FindPositionSGP4(double tsince) const
      */
     if (e <= -0.001)
     {
-        throw SatelliteException("Error: (e <= -0.001)");
+        return INVALID_ECCENTRICITY;
     }
     else if (e < 1.0e-6)
     {
@@ -474,10 +552,12 @@ Eci SGP4::FindPositionSGP4(double tsince) const
                                           common_consts_.x1mth2,
                                           common_consts_.x7thm1,
                                           common_consts_.cosio,
-                                          common_consts_.sinio);
+                                          common_consts_.sinio,
+                                          with_velocity,
+                                          eci);
 }
 
-Eci SGP4::CalculateFinalPositionVelocity(
+SGP4::Status SGP4::CalculateFinalPositionVelocity(
         const DateTime& dt,
         const double e,
         const double a,
@@ -491,10 +571,11 @@ Eci SGP4::CalculateFinalPositionVelocity(
         const double x1mth2,
         const double x7thm1,
         const double cosio,
-        const double sinio)
+        const double sinio,
+        const bool with_velocity,
+        Eci& eci) noexcept
 {
     const double beta2 = 1.0 - e * e;
-    const double xn = kXKE / pow(a, 1.5);
     /*
      * long period periodics
      */
@@ -508,7 +589,7 @@ Eci SGP4::CalculateFinalPositionVelocity(
 
     if (elsq >= 1.0)
     {
-        throw SatelliteException("Error: (elsq >= 1.0)");
+        return INVALID_LONG_PERIOD_ECCENTRICITY;
     }
 
     /*
@@ -589,13 +670,11 @@ Eci SGP4::CalculateFinalPositionVelocity(
 
     if (pl < 0.0)
     {
-        throw SatelliteException("Error: (pl < 0.0)");
+        return INVALID_SEMI_LATUS_RECTUM;
     }
 
     const double r = a * (1.0 - ecose);
     const double temp31 = 1.0 / r;
-    const double rdot = kXKE * sqrt(a) * esine * temp31;
-    const double rfdot = kXKE * sqrt(pl) * temp31;
     const double temp32 = a * temp31;
     const double betal = sqrt(temp21);
     const double temp33 = 1.0 / (1.0 + betal);
@@ -617,8 +696,6 @@ Eci SGP4::CalculateFinalPositionVelocity(
     const double uk = u - 0.25 * temp43 * x7thm1 * sin2u;
     const double xnodek = xnode + 1.5 * temp43 * cosio * sin2u;
     const double xinck = xinc + 1.5 * temp43 * cosio * sinio * cos2u;
-    const double rdotk = rdot - xn * temp42 * x1mth2 * sin2u;
-    const double rfdotk = rfdot + xn * temp42 * (x1mth2 * cos2u + 1.5 * x3thm1);
 
     /*
      * orientation vectors
@@ -634,9 +711,6 @@ Eci SGP4::CalculateFinalPositionVelocity(
     const double ux = xmx * sinuk + cosnok * cosuk;
     const double uy = xmy * sinuk + sinnok * cosuk;
     const double uz = sinik * sinuk;
-    const double vx = xmx * cosuk - cosnok * sinuk;
-    const double vy = xmy * cosuk - sinnok * sinuk;
-    const double vz = sinik * cosuk;
     /*
      * position and velocity
      */
@@ -644,20 +718,32 @@ Eci SGP4::CalculateFinalPositionVelocity(
     const double y = rk * uy * kXKMPER;
     const double z = rk * uz * kXKMPER;
     Vector position(x, y, z);
-    const double xdot = (rdotk * ux + rfdotk * vx) * kXKMPER / 60.0;
-    const double ydot = (rdotk * uy + rfdotk * vy) * kXKMPER / 60.0;
-    const double zdot = (rdotk * uz + rfdotk * vz) * kXKMPER / 60.0;
-    Vector velocity(xdot, ydot, zdot);
+    Vector velocity;
+
+    if (with_velocity)
+    {
+        const double xn = kXKE / pow(a, 1.5);
+        const double rdot = kXKE * sqrt(a) * esine * temp31;
+        const double rfdot = kXKE * sqrt(pl) * temp31;
+        const double rdotk = rdot - xn * temp42 * x1mth2 * sin2u;
+        const double rfdotk = rfdot + xn * temp42 * (x1mth2 * cos2u + 1.5 * x3thm1);
+        const double vx = xmx * cosuk - cosnok * sinuk;
+        const double vy = xmy * cosuk - sinnok * sinuk;
+        const double vz = sinik * cosuk;
+        const double xdot = (rdotk * ux + rfdotk * vx) * kXKMPER / 60.0;
+        const double ydot = (rdotk * uy + rfdotk * vy) * kXKMPER / 60.0;
+        const double zdot = (rdotk * uz + rfdotk * vz) * kXKMPER / 60.0;
+        velocity = Vector(xdot, ydot, zdot);
+    }
+
+    eci = Eci(dt, position, velocity);
 
     if (rk < 1.0)
     {
-        throw DecayedException(
-                dt,
-                position,
-                velocity);
+        return DECAYED;
     }
 
-    return Eci(dt, position, velocity);
+    return OK;
 }
 
 static inline double EvaluateCubicPolynomial(
@@ -36,16 +36,70 @@
 class SGP4
 {
 public:
+    /**
+     * @brief Outcome of an exception-free propagation.
+     */
+    enum Status
+    {
+        OK,
+        DECAYED,
+        INVALID_ECCENTRICITY,
+        INVALID_MEAN_MOTION,
+        INVALID_LONG_PERIOD_ECCENTRICITY,
+        INVALID_SEMI_LATUS_RECTUM
+    };
+
     SGP4(const Tle& tle)
         : elements_(tle)
     {
         Initialise();
     }
 
+    SGP4(const OrbitalElements& elements)
+        : elements_(elements)
+    {
+        Initialise();
+    }
+
     void SetTle(const Tle& tle);
+    void SetElements(const OrbitalElements& elements);
+
+    /**
+     * @returns the orbital elements the propagator was initialised with
+     */
+    const OrbitalElements& Elements() const
+    {
+        return elements_;
+    }
+
     Eci FindPosition(double tsince) const;
     Eci FindPosition(const DateTime& date) const;
 
+    /**
+     * Propagate without throwing, for bulk workloads
+     * @param[in] tsince minutes since epoch
+     * @param[out] eci the position, also filled in when DECAYED is returned
+     * @returns OK or the reason the elements could not be propagated
+     */
+    Status FindPosition(double tsince, Eci& eci) const noexcept;
+    Status FindPosition(const DateTime& date, Eci& eci) const noexcept;
+
+    /**
+     * Propagate the position only, skipping the velocity terms, for coarse
+     * visibility screening
+     * @param[in] tsince minutes since epoch
+     * @param[out] eci the position, the velocity is left zero
+     * @returns OK or the reason the elements could not be propagated
+     */
+    Status FindPositionOnly(double tsince, Eci& eci) const noexcept;
+    Status FindPositionOnly(const DateTime& date, Eci& eci) const noexcept;
+
+    /**
+     * @param[in] status a propagation status
+     * @returns the message the throwing api reports for the status
+     */
+    static const char* StatusMessage(Status status);
+
 private:
     struct CommonConstants
     {
@@ -173,9 +227,13 @@ private:
                                    double& x7thm1,
                                    double& xlcof,
                                    double& aycof);
-    Eci FindPositionSDP4(const double tsince) const;
-    Eci FindPositionSGP4(double tsince) const;
-    static Eci CalculateFinalPositionVelocity(
+    Status FindPositionSDP4(const double tsince,
+            const bool with_velocity,
+            Eci& eci) const noexcept;
+    Status FindPositionSGP4(double tsince,
+            const bool with_velocity,
+            Eci& eci) const noexcept;
+    static Status CalculateFinalPositionVelocity(
             const DateTime& date,
             const double e,
             const double a,
@@ -189,7 +247,9 @@ private:
             const double x1mth2,
             const double x7thm1,
             const double cosio,
-            const double sinio);
+            const double sinio,
+            const bool with_velocity,
+            Eci& eci) noexcept;
     /**
      * Deep space initialisation
      */
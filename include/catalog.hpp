@@ -0,0 +1,116 @@
+/**
+ * @file catalog.hpp
+ * @author Mit Bailey (mitbailey99@gmail.com)
+ * @brief Element set catalog with incremental, change-detecting updates.
+ * @version See Git tags for version information.
+ * @date 2026.10.18
+ *
+ * @copyright Copyright (c) 2021
+ *
+ */
+
+#ifndef CATALOG_HPP
+#define CATALOG_HPP
+
+#include <stdint.h>
+#include <istream>
+#include <unordered_map>
+#include <vector>
+#include "DateTime.h"
+#include "SGP4.h"
+
+#define CATALOG_MAX_SUBSCRIBERS 8
+
+typedef enum
+{
+    CATALOG_ADDED,
+    CATALOG_UPDATED,
+    CATALOG_REMOVED
+} catalog_change_type_t;
+
+typedef struct
+{
+    unsigned int norad;
+    catalog_change_type_t type;
+    uint32_t generation; // Generation of the entry after the change.
+} catalog_change_t;
+
+typedef struct
+{
+    SGP4 *model;
+    DateTime epoch;
+    uint64_t fingerprint; // Hash of the TLE lines or OMM element fields.
+    uint32_t generation;  // Bumped every time the model is re-initialized.
+    bool seen;            // Present in the update being applied.
+} catalog_entry_t;
+
+/**
+ * @brief Called once per update with the list of changed satellites.
+ *
+ */
+typedef void (*catalog_callback_t)(const std::vector<catalog_change_t> &changes, void *ctx);
+
+typedef struct
+{
+    std::unordered_map<unsigned int, catalog_entry_t> entries;
+    std::vector<catalog_change_t> changes; // Change list of the most recent update.
+    catalog_callback_t subscribers[CATALOG_MAX_SUBSCRIBERS];
+    void *subscriber_ctx[CATALOG_MAX_SUBSCRIBERS];
+    int num_subscribers = 0;
+} catalog_t;
+
+/**
+ * @brief Registers a callback that receives the change list after every update, e.g. to invalidate cached passes.
+ *
+ * @param catalog
+ * @param callback
+ * @param ctx Passed through to the callback.
+ * @return int 1 on success, negative on failure.
+ */
+int catalog_subscribe(catalog_t *catalog, catalog_callback_t callback, void *ctx);
+
+/**
+ * @brief Applies a full OMM (CSV or KVN) catalog pull. Only records whose epoch or elements changed re-initialize their model; satellites missing from the pull are removed.
+ *
+ * @param catalog
+ * @param stream
+ * @return int Number of changes on success, negative on failure.
+ */
+int catalog_update_omm(catalog_t *catalog, std::istream &stream);
+
+/**
+ * @brief Applies a full two- or three-line element catalog pull, compared by NORAD number and line contents.
+ *
+ * @param catalog
+ * @param stream
+ * @return int Number of changes on success, negative on failure.
+ */
+int catalog_update_tle(catalog_t *catalog, std::istream &stream);
+
+/**
+ * @brief Looks up a satellite.
+ *
+ * @param catalog
+ * @param norad
+ * @return const catalog_entry_t* nullptr if the satellite is not in the catalog.
+ */
+const catalog_entry_t *catalog_find(const catalog_t *catalog, unsigned int norad);
+
+/**
+ * @brief Checks whether something derived from generation `generation` of a satellite is still valid.
+ *
+ * @param catalog
+ * @param norad
+ * @param generation
+ * @return true The satellite has not changed since.
+ */
+bool catalog_is_current(const catalog_t *catalog, unsigned int norad, uint32_t generation);
+
+/**
+ * @brief Releases every model held by the catalog.
+ *
+ * @param catalog
+ */
+void catalog_destroy(catalog_t *catalog);
+
+#endif // CATALOG_HPP
@@ -0,0 +1,111 @@
+/**
+ * @file evloop.hpp
+ * @author Mit Bailey (mitbailey99@gmail.com)
+ * @brief Minimal epoll event loop with timerfd helpers.
+ * @version See Git tags for version information.
+ * @date 2026.10.18
+ *
+ * @copyright Copyright (c) 2021
+ *
+ */
+
+#ifndef EVLOOP_HPP
+#define EVLOOP_HPP
+
+#include <stdint.h>
+#include <time.h>
+#include <sys/epoll.h>
+
+#define EV_MAX_SOURCES 16
+#define EV_MAX_EVENTS 16
+
+/**
+ * @brief Called from ev_loop_run() when fd is ready.
+ *
+ */
+typedef void (*ev_handler_t)(int fd, uint32_t events, void *ctx);
+
+typedef struct
+{
+    int fd; // -1 when the slot is free.
+    ev_handler_t handler;
+    void *ctx;
+} ev_source_t;
+
+typedef struct
+{
+    int epfd;
+    bool running;
+    ev_source_t sources[EV_MAX_SOURCES];
+} ev_loop_t;
+
+/**
+ * @brief Creates the epoll instance.
+ *
+ * @param ev
+ * @return int 1 on success, negative on failure.
+ */
+int ev_loop_init(ev_loop_t *ev);
+
+/**
+ * @brief Starts watching a file descriptor.
+ *
+ * @param ev
+ * @param fd
+ * @param events EPOLLIN, EPOLLOUT, ...
+ * @param handler
+ * @param ctx Passed through to the handler.
+ * @return int 1 on success, negative on failure.
+ */
+int ev_add(ev_loop_t *ev, int fd, uint32_t events, ev_handler_t handler, void *ctx);
+
+/**
+ * @brief Stops watching a file descriptor. Safe to call from a handler, including the fd's own.
+ *
+ * @param ev
+ * @param fd
+ * @return int 1 on success, negative on failure.
+ */
+int ev_remove(ev_loop_t *ev, int fd);
+
+/**
+ * @brief Dispatches ready handlers until ev->running is cleared.
+ *
+ * @param ev
+ * @return int 1 when stopped, negative on an epoll error.
+ */
+int ev_loop_run(ev_loop_t *ev);
+
+/**
+ * @brief Closes the epoll instance. Watched descriptors are left open.
+ *
+ * @param ev
+ */
+void ev_loop_destroy(ev_loop_t *ev);
+
+/**
+ * @brief Creates a CLOCK_MONOTONIC timerfd, disarmed.
+ *
+ * @return int File descriptor on success, negative on failure.
+ */
+int ev_timer_create(void);
+
+/**
+ * @brief Arms a timer at an absolute CLOCK_MONOTONIC deadline. A deadline in the past fires immediately.
+ *
+ * @param tfd
+ * @param deadline nullptr disarms the timer.
+ * @param period Nanoseconds between later expirations, 0 for one-shot.
+ * @return int 1 on success, negative on failure.
+ */
+int ev_timer_arm(int tfd, const struct timespec *deadline, int64_t period);
+
+/**
+ * @brief Acknowledges a timer.
+ *
+ * @param tfd
+ * @return uint64_t Expirations since the last call, 0 if none.
+ */
+uint64_t ev_timer_read(int tfd);
+
+#endif // EVLOOP_HPP
@@ -0,0 +1,139 @@
+/**
+ * @file flightrec.hpp
+ * @author Mit Bailey (mitbailey99@gmail.com)
+ * @brief Flight recorder: one fixed-size binary record per tracking cycle in a memory-mapped file used as a ring,
+ * so the newest FLIGHTREC_RECORDS cycles survive a crash or restart for post-pass analysis.
+ * @version See Git tags for version information.
+ * @date 2026.10.18
+ *
+ * Recording is a copy into the mapping, no system call; the kernel writes dirty pages back. Export with
+ * tools/flightrec_csv.out.
+ *
+ * @copyright Copyright (c) 2021
+ *
+ */
+
+#ifndef FLIGHTREC_HPP
+#define FLIGHTREC_HPP
+
+#include <stdint.h>
+#include <stddef.h>
+#include "trackshm.hpp"
+
+#define FLIGHTREC_PATH "flightrec.bin" // default input of tools/flightrec_csv.out; the tracker records only with -R
+#define FLIGHTREC_RECORDS 262144 // records kept, 64 MiB; 7 hours at 10 Hz, 3 days at 1 Hz
+#define FLIGHTREC_MAGIC 0x43455246 // "FREC" little-endian
+#define FLIGHTREC_VERSION 1
+#define FLIGHTREC_HEADER_SIZE 4096 // bytes before the first record, one page
+#define FLIGHTREC_RECORD_SIZE 256 // bytes
+#define FLIGHTREC_GPIO_MAX 8 // GPIO transitions kept per cycle
+
+typedef enum
+{
+    FLIGHTREC_GPIO_IN,   // Pin set to input (high Z).
+    FLIGHTREC_GPIO_OUT,  // Pin set to output.
+    FLIGHTREC_GPIO_LOW,  // Output driven low.
+    FLIGHTREC_GPIO_HIGH  // Output driven high.
+} flightrec_gpio_kind_t;
+
+typedef struct
+{
+    uint8_t pin;
+    uint8_t kind; // flightrec_gpio_kind_t
+} flightrec_gpio_t;
+
+// Host byte order, the file is read back on the same machine.
+typedef struct
+{
+    uint64_t sequence;          // From 1 when the file was created, 0 while the slot is unused or being written.
+    int64_t mono_ns;            // CLOCK_MONOTONIC at the end of the cycle, the clock of the write times below.
+    track_snapshot_t snapshot;  // UTC time, look angles, commanded and dish position off the wrap.
+    double eci_position[3];     // kilometers, TEME, of the target at snapshot.time_us
+    double eci_velocity[3];     // kilometers per second
+    double cmd_az;              // degrees, last command on the cable wrap
+    double cmd_el;              // degrees, elevation axis (past 90 in a flipped pass)
+    int64_t write_start_ns[2];  // CLOCK_MONOTONIC first byte of the last command per axis (rot_axis_t), 0 if none
+    int64_t write_end_ns[2];    // CLOCK_MONOTONIC last byte
+    uint32_t commands[2];       // Commands written per axis, a change marks a new write.
+    uint8_t gpio_count;         // Transitions during this cycle, at most FLIGHTREC_GPIO_MAX.
+    uint8_t gpio_dropped;       // Transitions beyond FLIGHTREC_GPIO_MAX.
+    flightrec_gpio_t gpio[FLIGHTREC_GPIO_MAX];
+    uint8_t reserved[38];
+} flightrec_record_t;
+
+static_assert(sizeof(flightrec_record_t) == FLIGHTREC_RECORD_SIZE, "flight recorder layout changed, bump FLIGHTREC_VERSION");
+
+typedef struct
+{
+    uint32_t magic;
+    uint32_t version;
+    uint32_t record_size;
+    uint32_t capacity; // Records in the ring.
+    uint64_t next;     // Sequence number of the next record, from 1. Written after the record itself.
+} flightrec_header_t;
+
+typedef struct
+{
+    int fd;
+    flightrec_header_t *header; // nullptr when not mapped.
+    flightrec_record_t *records;
+    size_t size; // Bytes mapped.
+    bool writer;
+} flightrec_t;
+
+/**
+ * @brief Opens the recorder file for writing, continuing after the last record if it has the same layout and
+ * starting it over otherwise. Disk space is reserved up front so a write never faults on a full disk, the open fails
+ * if the file system does not have it.
+ *
+ * @param rec
+ * @param path
+ * @param capacity Records kept, e.g. FLIGHTREC_RECORDS.
+ * @return int 1 on success, negative on failure.
+ */
+int flightrec_open(flightrec_t *rec, const char *path, uint32_t capacity);
+
+/**
+ * @brief Maps an existing recorder file read-only. It may still be being written.
+ *
+ * @param rec
+ * @param path
+ * @return int 1 on success, negative if the file is missing or not a flight recorder of this version.
+ */
+int flightrec_attach(flightrec_t *rec, const char *path);
+
+/**
+ * @brief Appends a record, overwriting the oldest once the ring is full. Sets the record's sequence.
+ *
+ * @param rec
+ * @param record
+ */
+void flightrec_write(flightrec_t *rec, flightrec_record_t *record);
+
+/**
+ * @brief Sequence numbers currently held, oldest first: first to first + count - 1.
+ *
+ * @param rec
+ * @param first
+ * @return uint64_t Count.
+ */
+uint64_t flightrec_range(const flightrec_t *rec, uint64_t *first);
+
+/**
+ * @brief Copies the record with a given sequence number.
+ *
+ * @param rec
+ * @param sequence
+ * @param record
+ * @return true The record is held and was not overwritten while copying.
+ */
+bool flightrec_read(const flightrec_t *rec, uint64_t sequence, flightrec_record_t *record);
+
+/**
+ * @brief Unmaps the file, the writer flushes it to disk first.
+ *
+ * @param rec
+ */
+void flightrec_close(flightrec_t *rec);
+
+#endif // FLIGHTREC_HPP
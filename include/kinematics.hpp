@@ -0,0 +1,87 @@
+/**
+ * @file kinematics.hpp
+ * @author Mit Bailey (mitbailey99@gmail.com)
+ * @brief Rotator axis kinematics model and a command schedule generator checked against it.
+ * @version See Git tags for version information.
+ * @date 2026.10.18
+ *
+ * @copyright Copyright (c) 2021
+ *
+ */
+
+#ifndef KINEMATICS_HPP
+#define KINEMATICS_HPP
+
+#include <stddef.h>
+
+#define AZ_ACCEL 2.0 // degrees per second squared
+#define EL_ACCEL 2.0
+#define AZ_BACKLASH 0.5 // degrees of lost motion on a reversal
+#define EL_BACKLASH 0.5
+#define CMD_QUANTUM 1.0 // degrees, the controller takes whole degrees ("%03d")
+#define CMD_MIN_INTERVAL 0.4 // seconds between commands to one axis, both share the paced serial line
+
+typedef struct
+{
+    double max_rate;     // degrees per second
+    double accel;        // degrees per second squared
+    double backlash;     // degrees
+    double quantum;      // degrees
+    double min_interval; // seconds
+} axis_model_t;
+
+typedef struct
+{
+    double motor;  // degrees, drive side
+    double rate;   // degrees per second
+    double output; // degrees, dish side of the backlash
+} axis_state_t;
+
+typedef struct
+{
+    int commands;        // Commands in the schedule.
+    int infeasible;      // Samples where the path is faster than max_rate.
+    double mean_error;   // degrees, predicted |path - axis| over the schedule
+    double max_error;    // degrees
+} axis_plan_report_t;
+
+/**
+ * @brief Time to move an axis from rest to rest over a distance with a trapezoidal (or triangular) rate profile.
+ *
+ * @param model
+ * @param distance Degrees.
+ * @return double Seconds.
+ */
+double axis_move_time(const axis_model_t *model, double distance);
+
+/**
+ * @brief Advances an axis one step toward target: rate and acceleration limited motor, output following through
+ * the backlash dead zone.
+ *
+ * @param model
+ * @param target Commanded angle, degrees.
+ * @param step Seconds.
+ * @param state
+ */
+void axis_simulate(const axis_model_t *model, double target, double step, axis_state_t *state);
+
+/**
+ * @brief Generates the command staircase for an axis following path.
+ *
+ * Commands are quantized and switched when the path crosses the midpoint between levels, so the axis sits on
+ * either side of the path instead of trailing it by up to a deadband. Switches are held to min_interval, carry
+ * backlash compensation on reversals, and the resulting motion is simulated with the model to report the
+ * predicted pointing error and any stretch the axis cannot follow.
+ *
+ * @param model
+ * @param path Axis angles, degrees, one per step.
+ * @param n Number of samples.
+ * @param step Seconds between samples.
+ * @param start Axis angle at the first sample, degrees.
+ * @param commands Receives the commanded angle effective at each sample, degrees.
+ * @param report May be nullptr.
+ * @return int Number of commands on success, negative on failure.
+ */
+int axis_plan_commands(const axis_model_t *model, const float *path, size_t n, double step, double start, float *commands, axis_plan_report_t *report);
+
+#endif // KINEMATICS_HPP
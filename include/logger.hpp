@@ -0,0 +1,227 @@
+/**
+ * @file logger.hpp
+ * @author Mit Bailey (mitbailey99@gmail.com)
+ * @brief Asynchronous logging backend: callers pack a binary record into a per-thread lock-free ring, a background
+ * thread formats and writes it.
+ * @version See Git tags for version information.
+ * @date 2026.10.18
+ *
+ * @copyright Copyright (c) 2021
+ *
+ */
+
+#ifndef LOGGER_HPP
+#define LOGGER_HPP
+
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+#include <tuple>
+#include <type_traits>
+
+#define LOG_DEBUG 0
+#define LOG_INFO 1
+#define LOG_WARN 2
+#define LOG_ERROR 3
+
+// Calls below this level compile to nothing, e.g. make CXXFLAGS=-DLOG_LEVEL=LOG_INFO for production.
+#ifndef LOG_LEVEL
+#define LOG_LEVEL LOG_DEBUG
+#endif
+
+#define LOG_MAX_THREADS 16 // rings; a thread that finds none free logs synchronously
+#define LOG_RING_SLOTS 256 // records per thread, a full ring drops records rather than block
+#define LOG_ARGS_SIZE 192 // bytes of packed arguments per record
+#define LOG_STR_MAX 96 // characters kept of each string argument
+#define LOG_FLUSH_NS 2000000 // logger_flush() poll interval
+
+typedef int (*log_formatter_t)(char *out, size_t size, const char *format, const unsigned char *args);
+
+typedef struct
+{
+    int64_t time;              // CLOCK_MONOTONIC nanoseconds, orders records across threads.
+    const char *file;          // String literals, stored by pointer.
+    const char *func;
+    const char *format;
+    log_formatter_t formatter; // Instantiated for the argument types of the call.
+    int line;
+    int level;
+    bool newline;
+    bool truncated;            // Arguments did not fit in args, only the format is written.
+    unsigned char args[LOG_ARGS_SIZE];
+} log_record_t;
+
+/**
+ * @brief Reserves the calling thread's next record slot, registering a ring on first use.
+ *
+ * @param fallback Returned when no ring is free, the record is then written synchronously by logger_commit().
+ * @return log_record_t* nullptr if the ring is full, the record is counted as dropped.
+ */
+log_record_t *logger_reserve(log_record_t *fallback);
+
+/**
+ * @brief Publishes a record from logger_reserve() to the writer.
+ *
+ * @param record
+ */
+void logger_commit(log_record_t *record);
+
+/**
+ * @brief Writes everything queued so far and waits for it. Also runs at exit.
+ *
+ */
+void logger_flush();
+
+/**
+ * @brief Severity of a dbprintlf() call from its color prefix, see meb_debug.h.
+ *
+ */
+constexpr bool logger_has_prefix(const char *s, const char *prefix)
+{
+    return *prefix == '\0' ? true : (*s == *prefix && logger_has_prefix(s + 1, prefix + 1));
+}
+
+constexpr int logger_level_of(const char *format)
+{
+    return logger_has_prefix(format, "\033[1m\x1b[107m\x1b[31m") ? LOG_ERROR
+           : (logger_has_prefix(format, "\x1b[91m") || logger_has_prefix(format, "\x1b[101m")) ? LOG_WARN
+           : (logger_has_prefix(format, "\x1b[92m") || logger_has_prefix(format, "\x1b[33m") || logger_has_prefix(format, "\x1b[95m") || logger_has_prefix(format, "\x1b[96m")) ? LOG_INFO
+                                                                                                                                                                     : LOG_DEBUG;
+}
+
+// Argument packing: numbers and pointers by value, strings copied (up to LOG_STR_MAX) since they may not outlive
+// the call.
+
+template <typename T>
+struct log_is_string : std::integral_constant<bool, std::is_same<typename std::decay<T>::type, char *>::value || std::is_same<typename std::decay<T>::type, const char *>::value>
+{
+};
+
+template <typename T>
+using log_stored_t = typename std::conditional<log_is_string<T>::value, const char *,
+                                               typename std::conditional<std::is_floating_point<typename std::decay<T>::type>::value, double,
+                                                                         typename std::decay<T>::type>::type>::type;
+
+template <typename T>
+static inline bool log_pack(unsigned char *args, size_t &offset, const T &value)
+{
+    if constexpr (log_is_string<T>::value)
+    {
+        const char *s = value;
+        s = s != nullptr ? s : "(null)";
+        // Counted by hand: strnlen() with a bound past the end of a short literal trips -Wstringop-overread.
+        uint16_t len = 0;
+        while (len < LOG_STR_MAX && s[len] != '\0')
+        {
+            len++;
+        }
+        if (offset + sizeof(len) + len + 1 > LOG_ARGS_SIZE)
+        {
+            return false;
+        }
+        memcpy(args + offset, &len, sizeof(len));
+        memcpy(args + offset + sizeof(len), s, len);
+        args[offset + sizeof(len) + len] = '\0';
+        offset += sizeof(len) + len + 1;
+    }
+    else
+    {
+        static_assert(std::is_trivially_copyable<log_stored_t<T>>::value, "log arguments must be numbers, pointers or strings");
+        log_stored_t<T> stored = value;
+        if (offset + sizeof(stored) > LOG_ARGS_SIZE)
+        {
+            return false;
+        }
+        memcpy(args + offset, &stored, sizeof(stored));
+        offset += sizeof(stored);
+    }
+    return true;
+}
+
+template <typename T>
+static inline log_stored_t<T> log_unpack(const unsigned char *args, size_t &offset)
+{
+    if constexpr (log_is_string<T>::value)
+    {
+        uint16_t len;
+        memcpy(&len, args + offset, sizeof(len));
+        const char *s = (const char *)args + offset + sizeof(len);
+        offset += sizeof(len) + len + 1;
+        return s;
+    }
+    else
+    {
+        log_stored_t<T> stored;
+        memcpy(&stored, args + offset, sizeof(stored));
+        offset += sizeof(stored);
+        return stored;
+    }
+}
+
+template <typename... Args>
+static int log_format(char *out, size_t size, const char *format, const unsigned char *args)
+{
+    if constexpr (sizeof...(Args) == 0)
+    {
+        return snprintf(out, size, "%s", format);
+    }
+    else
+    {
+        // Braced initialization unpacks left to right.
+        size_t offset = 0;
+        std::tuple<log_stored_t<Args>...> values{log_unpack<Args>(args, offset)...};
+        return std::apply([&](auto... value)
+                          { return snprintf(out, size, format, value...); },
+                          values);
+    }
+}
+
+template <typename... Args>
+static inline void log_submit(int level, const char *file, int line, const char *func, bool newline, const char *format, const Args &...args)
+{
+    log_record_t fallback;
+    log_record_t *record = logger_reserve(&fallback);
+    if (record == nullptr)
+    {
+        return;
+    }
+
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    record->time = now.tv_sec * 1000000000LL + now.tv_nsec;
+    record->file = file;
+    record->func = func;
+    record->format = format;
+    record->formatter = log_format<Args...>;
+    record->line = line;
+    record->level = level;
+    record->newline = newline;
+
+    size_t offset = 0;
+    record->truncated = !(log_pack(record->args, offset, args) && ... && true);
+    (void)offset;
+
+    logger_commit(record);
+}
+
+/**
+ * @brief Logs at a fixed level. Arguments are not evaluated when the level is compiled out.
+ *
+ */
+#define logprintlf(level, format, ...) log_emit(level, true, format, ##__VA_ARGS__)
+
+#define log_emit(level, newline, format, ...)                                                      \
+    do                                                                                             \
+    {                                                                                              \
+        if constexpr ((level) >= LOG_LEVEL)                                                        \
+        {                                                                                          \
+            if (false)                                                                             \
+            {                                                                                      \
+                fprintf(stderr, format, ##__VA_ARGS__); /* printf format checking only */          \
+            }                                                                                      \
+            log_submit((level), __FILE__, __LINE__, __func__, newline, format, ##__VA_ARGS__);     \
+        }                                                                                          \
+    } while (0)
+
+#endif // LOGGER_HPP
@@ -14,24 +14,6 @@
 
 #include <stdio.h>
 
-#ifndef dbprintlf
-#define dbprintlf(format, ...)                                                                        \
-    fprintf(stderr, "[%s:%d | %s] " format "\x1b[0m\n", __FILE__, __LINE__, __func__, ##__VA_ARGS__); \
-    fflush(stderr);
-#endif // dbprintlf
-
-#ifndef dbprintf
-#define dbprintf(format, ...)                                                                       \
-    fprintf(stderr, "[%s:%d | %s] " format "\x1b[0m", __FILE__, __LINE__, __func__, ##__VA_ARGS__); \
-    fflush(stderr);
-#endif // dbprintf
-
-#ifndef erprintlf
-#define erprintlf(error)                                                                                               \
-    fprintf(stderr, "[%s:%d | %s] \x1b[94m>>> %d: %s\x1b[0m\n", __FILE__, __LINE__, __func__, error, strerror(error)); \
-    fflush(stderr);
-#endif // erprintlf
-
 #ifndef MEB_COLORS
 #define MEB_COLORS
 #define RESET_ALL "\x1b[0m"
@@ -54,4 +36,44 @@
 #define FATAL "\033[1m\x1b[107m\x1b[31m(FATAL) "
 #endif // MEB_CODES
 
+// C++ sources log through the asynchronous backend in logger.hpp. The level of a dbprintlf() comes from its color:
+// FATAL is an error, red a warning, green/yellow/magenta/cyan information, anything else debug output. Define
+// MEB_DEBUG_SYNC for the original synchronous stderr output.
+#if defined(__cplusplus) && !defined(MEB_DEBUG_SYNC)
+#include "logger.hpp"
+
+#ifndef dbprintlf
+#define dbprintlf(format, ...) log_emit(logger_level_of(format), true, format, ##__VA_ARGS__)
+#endif // dbprintlf
+
+#ifndef dbprintf
+#define dbprintf(format, ...) log_emit(logger_level_of(format), false, format, ##__VA_ARGS__)
+#endif // dbprintf
+
+#ifndef erprintlf
+#define erprintlf(error) log_emit(LOG_ERROR, true, "\x1b[94m>>> %d: %s", error, strerror(error))
+#endif // erprintlf
+
+#else
+
+#ifndef dbprintlf
+#define dbprintlf(format, ...)                                                                        \
+    fprintf(stderr, "[%s:%d | %s] " format "\x1b[0m\n", __FILE__, __LINE__, __func__, ##__VA_ARGS__); \
+    fflush(stderr);
+#endif // dbprintlf
+
+#ifndef dbprintf
+#define dbprintf(format, ...)                                                                       \
+    fprintf(stderr, "[%s:%d | %s] " format "\x1b[0m", __FILE__, __LINE__, __func__, ##__VA_ARGS__); \
+    fflush(stderr);
+#endif // dbprintf
+
+#ifndef erprintlf
+#define erprintlf(error)                                                                                               \
+    fprintf(stderr, "[%s:%d | %s] \x1b[94m>>> %d: %s\x1b[0m\n", __FILE__, __LINE__, __func__, error, strerror(error)); \
+    fflush(stderr);
+#endif // erprintlf
+
+#endif // __cplusplus && !MEB_DEBUG_SYNC
+
 #endif // MEB_DEBUG_HPP
\ No newline at end of file
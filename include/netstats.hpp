@@ -0,0 +1,161 @@
+/**
+ * @file netstats.hpp
+ * @author Mit Bailey (mitbailey99@gmail.com)
+ * @brief Link instrumentation: per-type frame and byte counters, ACK round-trip histogram, unacknowledged frames.
+ * @version See Git tags for version information.
+ * @date 2026.10.18
+ *
+ * @copyright Copyright (c) 2021
+ *
+ */
+
+#ifndef NETSTATS_HPP
+#define NETSTATS_HPP
+
+#include <stdint.h>
+#include <time.h>
+
+#define NETSTATS_TYPES 8 // NetType values tracked, see netstats_type_index()
+#define NETSTATS_INFLIGHT 64 // frames awaiting an ACK
+#define NETSTATS_RTT_BINS 14 // bin 0 below 1 ms, bin i from 2^(i-1) ms, last bin open-ended
+#define NETSTATS_ACK_TIMEOUT 5.0 // seconds before an unacknowledged frame counts as lost
+#define NETSTATS_INTERVAL 60 // seconds between stats frames to the server
+#define NETSTATS_SOCKET "/tmp/gs_track_netstats.sock" // local query endpoint, answers every connection with a text report
+#define NETSTATS_MAGIC 0x4154534e // "NSTA" little-endian
+#define NETSTATS_VERSION 1
+
+typedef struct
+{
+    uint64_t frames;
+    uint64_t bytes;
+} netstats_count_t;
+
+typedef struct
+{
+    uint32_t sequence;
+    struct timespec sent;
+} netstats_inflight_t;
+
+typedef struct
+{
+    netstats_count_t sent[NETSTATS_TYPES];
+    netstats_count_t received[NETSTATS_TYPES];
+    netstats_count_t failed[NETSTATS_TYPES]; // sendFrame() errors.
+    uint64_t unacked;                        // Frames without an ACK within NETSTATS_ACK_TIMEOUT.
+    uint64_t nacked;                         // Frames answered with a NACK.
+    uint64_t discarded;                      // Frames dropped from RTT matching after a NACK or timeout.
+    uint64_t rtt_bins[NETSTATS_RTT_BINS];
+    uint64_t rtt_count;
+    double rtt_sum; // seconds
+    double rtt_max;
+    uint32_t sequence; // Of the next frame sent.
+    struct timespec start;
+
+    // ACKs carry no sequence number, so they are matched to frames awaiting one in order. One lost ACK would shift
+    // every later pairing, so the window is cleared after a NACK or a timeout and matching starts over.
+    netstats_inflight_t inflight[NETSTATS_INFLIGHT];
+    int inflight_head;
+    int inflight_count;
+} netstats_t;
+
+// Stats frame payload, host byte order.
+typedef struct __attribute__((packed))
+{
+    uint32_t magic;
+    uint16_t version;
+    uint16_t reserved;
+    uint32_t sequence; // Frames sent so far.
+    float uptime;      // seconds
+    uint64_t sent_frames;
+    uint64_t sent_bytes;
+    uint64_t received_frames;
+    uint64_t received_bytes;
+    uint64_t failed;
+    uint64_t unacked;
+    float rtt_mean; // milliseconds
+    float rtt_max;
+    uint32_t rtt_bins[NETSTATS_RTT_BINS];
+} netstats_report_t;
+
+/**
+ * @brief Clears all counters.
+ *
+ * @param stats
+ */
+void netstats_init(netstats_t *stats);
+
+/**
+ * @brief Maps a NetType value to a counter slot.
+ *
+ * @param type (int)NetType
+ * @return int 0 to NETSTATS_TYPES - 1, the last slot for unknown types.
+ */
+int netstats_type_index(int type);
+
+/**
+ * @brief Counts a frame handed to sendFrame().
+ *
+ * @param stats
+ * @param type (int)NetType
+ * @param bytes Bytes sent, negative if the send failed.
+ * @param expects_ack The server answers this frame with an ACK.
+ * @return uint32_t Sequence number given to the frame.
+ */
+uint32_t netstats_sent(netstats_t *stats, int type, long bytes, bool expects_ack);
+
+/**
+ * @brief Counts a received frame; an ACK completes the oldest frame awaiting one with an RTT sample, a NACK
+ * completes it without one and clears the rest of the window.
+ *
+ * @param stats
+ * @param type (int)NetType
+ * @param bytes
+ * @param now CLOCK_MONOTONIC time it was read.
+ */
+void netstats_received(netstats_t *stats, int type, long bytes, const struct timespec *now);
+
+/**
+ * @brief Gives up on frames that have waited longer than NETSTATS_ACK_TIMEOUT, and then on the rest of the window
+ * since their pairing with later ACKs can no longer be trusted.
+ *
+ * @param stats
+ * @param now CLOCK_MONOTONIC
+ * @return int Frames given up on.
+ */
+int netstats_expire(netstats_t *stats, const struct timespec *now);
+
+/**
+ * @brief Fills the stats frame payload.
+ *
+ * @param stats
+ * @param report
+ */
+void netstats_report(const netstats_t *stats, netstats_report_t *report);
+
+/**
+ * @brief Human-readable report, as served on NETSTATS_SOCKET.
+ *
+ * @param stats
+ * @param buffer
+ * @param size
+ * @return int Length written.
+ */
+int netstats_format(const netstats_t *stats, char *buffer, int size);
+
+/**
+ * @brief Opens the local query endpoint, a listening Unix stream socket. A stale socket file is replaced.
+ *
+ * @param path
+ * @return int Nonblocking listening socket, negative on failure.
+ */
+int netstats_listen(const char *path);
+
+/**
+ * @brief Answers one pending connection on the query endpoint with netstats_format() and closes it.
+ *
+ * @param stats
+ * @param listener
+ */
+void netstats_serve(const netstats_t *stats, int listener);
+
+#endif // NETSTATS_HPP
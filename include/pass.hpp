@@ -0,0 +1,134 @@
+/**
+ * @file pass.hpp
+ * @author Mit Bailey (mitbailey99@gmail.com)
+ * @brief Precomputed look-angle table for one pass, so in-pass pointing is a lookup instead of a propagation.
+ * @version See Git tags for version information.
+ * @date 2026.10.18
+ *
+ * @copyright Copyright (c) 2021
+ *
+ */
+
+#ifndef PASS_HPP
+#define PASS_HPP
+
+#include <stdint.h>
+#include <vector>
+#include "DateTime.h"
+#include "Observer.h"
+#include "SGP4.h"
+#include "kinematics.hpp"
+
+#define PASS_TABLE_RATE 10       // samples per second
+#define PASS_MAX_DURATION 1800   // seconds, longest table built
+
+typedef struct
+{
+    float az;         // degrees, 0 to 360
+    float az_wrap;    // degrees, az on the planned cable wrap, see pass_plan_wrap()
+    float el;         // degrees
+    float el_axis;    // degrees, elevation to command, past 90 in a flipped pass
+    float range_rate; // kilometers per second
+    float az_cmd;     // degrees, scheduled azimuth command, see pass_plan_commands()
+    float el_cmd;     // degrees, scheduled elevation command
+} pass_sample_t;
+
+typedef struct
+{
+    const SGP4 *model;   // Model the table was built from.
+    uint32_t generation; // Element set generation of the model.
+    DateTime start;      // Time of samples[0].
+    double step;         // seconds between samples
+    int unwinds;         // Full turns back the planned wrap makes during the pass.
+    bool flipped;        // Axes follow (az + 180, 180 - el).
+    double peak_az_rate; // degrees per second, of the unmodified path
+    bool scheduled;      // az_cmd and el_cmd are valid.
+    axis_plan_report_t az_report;
+    axis_plan_report_t el_report;
+    std::vector<pass_sample_t> samples;
+} pass_t;
+
+/**
+ * @brief Samples the look angle from start until the object sets below min_elev (or PASS_MAX_DURATION).
+ *
+ * @param pass
+ * @param model
+ * @param generation Element set generation, see pass_is_current().
+ * @param dish
+ * @param start First sample, normally the rise time or now.
+ * @param min_elev Degrees.
+ * @return int Number of samples on success, negative on failure.
+ */
+int pass_build(pass_t *pass, const SGP4 *model, uint32_t generation, Observer *dish, const DateTime &start, double min_elev);
+
+/**
+ * @brief Chooses the cable wrap for the whole pass: the continuous azimuth path is placed inside the mechanical
+ * range at the offset that minimizes the slew from the current position plus 360 degrees per unwind. With a range
+ * of more than 360 degrees a pass that crosses the range ends can usually be followed without any unwind.
+ *
+ * @param pass
+ * @param current Current azimuth on the wrap, degrees.
+ * @param az_min Mechanical range in the same frame, degrees. Must span at least 360 degrees.
+ * @param az_max
+ * @return int Number of unwinds on success, negative on failure.
+ */
+int pass_plan_wrap(pass_t *pass, double current, double az_min, double az_max);
+
+/**
+ * @brief Plans the axis angles for the whole pass. Chooses the direct or, if the elevation axis reaches el_max past
+ * 90 degrees, flipped form by cable-wrap cost; if the pass needs more than max_az_rate in azimuth (a near-zenith
+ * keyhole pass), replaces the azimuth path by a rate-limited swing that starts ahead of culmination; then plans the
+ * cable wrap.
+ *
+ * @param pass
+ * @param current Current azimuth on the wrap, degrees.
+ * @param az_min Mechanical range, degrees, see pass_plan_wrap().
+ * @param az_max
+ * @param el_max Highest elevation axis angle, degrees.
+ * @param max_az_rate Degrees per second.
+ * @return int Number of unwinds on success, negative on failure.
+ */
+int pass_plan_pointing(pass_t *pass, double current, double az_min, double az_max, double el_max, double max_az_rate);
+
+/**
+ * @brief Generates the command schedule for both axes along the planned axis path.
+ *
+ * @param pass
+ * @param az Azimuth axis model.
+ * @param el Elevation axis model.
+ * @param az_start Azimuth axis angle now, degrees on the wrap.
+ * @param el_start Elevation axis angle now, degrees.
+ * @return int 1 on success, negative on failure.
+ */
+int pass_plan_commands(pass_t *pass, const axis_model_t *az, const axis_model_t *el, double az_start, double el_start);
+
+/**
+ * @brief Checks that the table was built from this element set and covers t.
+ *
+ * @param pass
+ * @param model
+ * @param generation
+ * @param t
+ * @return true pass_lookup() can be used for t.
+ */
+bool pass_is_current(const pass_t *pass, const SGP4 *model, uint32_t generation, const DateTime &t);
+
+/**
+ * @brief Linearly interpolates the table at t, azimuth across north and the axis angles along the planned path.
+ * Scheduled commands are not interpolated.
+ *
+ * @param pass
+ * @param t
+ * @param sample
+ * @return int 1 on success, negative if t is outside the table.
+ */
+int pass_lookup(const pass_t *pass, const DateTime &t, pass_sample_t *sample);
+
+/**
+ * @brief Empties the table.
+ *
+ * @param pass
+ */
+void pass_clear(pass_t *pass);
+
+#endif // PASS_HPP
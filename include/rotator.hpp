@@ -0,0 +1,216 @@
+/**
+ * @file rotator.hpp
+ * @author Mit Bailey (mitbailey99@gmail.com)
+ * @brief Byte-paced, non-blocking command writer for the dish rotator controller.
+ * @version See Git tags for version information.
+ * @date 2026.10.18
+ *
+ * @copyright Copyright (c) 2021
+ *
+ */
+
+#ifndef ROTATOR_HPP
+#define ROTATOR_HPP
+
+#include <pthread.h>
+#include <stdint.h>
+#include <time.h>
+
+#define ROT_CHAR_PACING 20000000 // nanoseconds between command bytes
+#define ROT_CMD_SIZE 0x10
+#define ROT_RX_SIZE 0x40
+#define ROT_QUERY_INTERVAL 0.5 // seconds between position queries per axis
+#define ROT_AZ_MIN 0.0 // controller degrees, mechanical azimuth range
+#define ROT_AZ_MAX 360.0
+#define ROT_EL_MAX 90.0 // degrees, above 90 allows flipped passes
+#define ROT_FEEDBACK_STALE 2.0 // seconds after which a measured position is no longer trusted
+
+#define AZ_RESPONSE_TIME 0.25 // seconds from last command byte until the azimuth motor starts
+#define EL_RESPONSE_TIME 0.25 // seconds from last command byte until the elevation motor starts
+#define AZ_SLEW_RATE 4.0 // degrees per second
+#define EL_SLEW_RATE 4.0 // degrees per second
+#define CMD_WRITE_TIME 0.16 // seconds, initial estimate from request to last command byte
+#define LATENCY_EWMA_ALPHA 0.2 // weight of each new write-time measurement
+
+typedef enum
+{
+    ROT_AZ,
+    ROT_EL,
+    ROT_NUM_AXES
+} rot_axis_t;
+
+typedef struct
+{
+    double write_time;    // seconds, measured time from request to last command byte (EWMA)
+    double response_time; // seconds, configured controller response after the write
+    double slew_rate;     // degrees per second, configured mechanical rate
+} axis_latency_t;
+
+typedef struct
+{
+    int connection;
+    pthread_mutex_t lock;
+    int64_t pacing;    // Real nanoseconds between command bytes.
+    double time_scale; // Simulated seconds per real second, see simclock.hpp.
+
+    // Requests, guarded by lock.
+    bool pending[ROT_NUM_AXES];
+    double target[ROT_NUM_AXES];                 // Latest requested angle, degrees.
+    struct timespec requested[ROT_NUM_AXES];     // When the pending target was first requested.
+    axis_latency_t latency[ROT_NUM_AXES];
+    uint64_t commands[ROT_NUM_AXES];             // Commands written.
+    uint64_t coalesced[ROT_NUM_AXES];            // Requests superseded before being written.
+    bool query_pending[ROT_NUM_AXES];
+    struct timespec started[ROT_NUM_AXES];       // When the last command's first byte was written.
+    struct timespec written[ROT_NUM_AXES];       // When the last command finished writing.
+    bool priority[ROT_NUM_AXES];                 // The pending target is an operator command, see rotator_preempt().
+    uint64_t preempts;                           // Operator commands written.
+    double preempt_latency_max;                  // Seconds from frame receipt to the first command byte.
+    double preempt_latency_sum;
+
+    // Position reports, guarded by lock.
+    bool has_measured[ROT_NUM_AXES];
+    double measured[ROT_NUM_AXES];               // Degrees, tracker frame (AZIM_ADJ removed).
+    struct timespec measured_at[ROT_NUM_AXES];   // CLOCK_MONOTONIC time the report was read.
+    uint64_t reports[ROT_NUM_AXES];
+
+    // Owned by whoever calls rotator_service().
+    int active; // Axis being written, -1 when idle.
+    bool active_query; // The active command is a position query.
+    bool active_priority; // The active command is an operator command.
+    int last_axis;
+    struct timespec last_query[ROT_NUM_AXES];
+    char command[ROT_CMD_SIZE];
+    int command_len;
+    int sent;
+    struct timespec active_requested;
+    struct timespec next_byte;
+
+    // Owned by whoever calls rotator_read().
+    char rx[ROT_RX_SIZE];
+    int rx_len;
+} rotator_t;
+
+/**
+ * @brief Expected time from requesting a command until the axis reaches the commanded angle.
+ *
+ * @param latency
+ * @param travel Angle the axis has to move, degrees.
+ * @return double Seconds.
+ */
+double axis_latency_predict(const axis_latency_t *latency, double travel);
+
+/**
+ * @brief Folds a measured request-to-written duration into the latency model.
+ *
+ * @param latency
+ * @param write_time Seconds.
+ */
+void axis_latency_record(axis_latency_t *latency, double write_time);
+
+/**
+ * @brief Prepares the writer for an open serial connection.
+ *
+ * @param rot
+ * @param connection
+ * @return int 1 on success, negative on failure.
+ */
+int rotator_init(rotator_t *rot, int connection);
+
+/**
+ * @brief Requests that an axis be moved. Never blocks on the serial line; a request that has not started
+ * writing yet is replaced by the newer one.
+ *
+ * @param rot
+ * @param axis
+ * @param angle Degrees.
+ */
+void rotator_command(rotator_t *rot, rot_axis_t axis, double angle);
+
+/**
+ * @brief Queues an operator command ahead of everything else. It replaces any pending request for the axis, and
+ * rotator_command() cannot replace it until it is written. Only a command already on the line goes first, so the
+ * first byte follows within one command (ROT_CMD_SIZE bytes at the pacing) plus the other axis' operator command.
+ *
+ * @param rot
+ * @param axis
+ * @param angle Degrees.
+ * @param received CLOCK_MONOTONIC time the request arrived, the start of the measured latency.
+ */
+void rotator_preempt(rotator_t *rot, rot_axis_t axis, double angle, const struct timespec *received);
+
+/**
+ * @brief Queues a position query for each axis whose last query is older than ROT_QUERY_INTERVAL. Queries are
+ * written after any pending move commands.
+ *
+ * @param rot
+ */
+void rotator_query(rotator_t *rot);
+
+/**
+ * @brief Reads whatever the controller has sent without blocking and records any complete position reports.
+ *
+ * @param rot
+ * @return int Number of reports parsed, negative on a read error.
+ */
+int rotator_read(rotator_t *rot);
+
+/**
+ * @brief Latest measured position of an axis.
+ *
+ * @param rot
+ * @param axis
+ * @param angle Degrees.
+ * @param age Seconds since the report was read, may be nullptr.
+ * @return true A report newer than ROT_FEEDBACK_STALE exists.
+ */
+bool rotator_get_measured(rotator_t *rot, rot_axis_t axis, double *angle, double *age);
+
+/**
+ * @brief Seconds since the last command for an axis finished writing.
+ *
+ * @param rot
+ * @param axis
+ * @return double Seconds, negative if none was written yet.
+ */
+double rotator_since_command(rotator_t *rot, rot_axis_t axis);
+
+/**
+ * @brief Serial write times of the last command for an axis, CLOCK_MONOTONIC.
+ *
+ * @param rot
+ * @param axis
+ * @param started First byte.
+ * @param written Last byte.
+ * @return uint64_t Commands written so far, 0 if none (the times are then zero).
+ */
+uint64_t rotator_get_writes(rotator_t *rot, rot_axis_t axis, struct timespec *started, struct timespec *written);
+
+/**
+ * @brief Checks whether a command is being written or waiting to be.
+ *
+ * @param rot
+ * @return true rotator_service() has work to do.
+ */
+bool rotator_busy(rotator_t *rot);
+
+/**
+ * @brief Copies the current latency model of an axis.
+ *
+ * @param rot
+ * @param axis
+ * @param latency
+ */
+void rotator_get_latency(rotator_t *rot, rot_axis_t axis, axis_latency_t *latency);
+
+/**
+ * @brief Writes the next byte of the active command if its pacing deadline has passed, starting the next
+ * pending command when idle.
+ *
+ * @param rot
+ * @param next Set to the deadline for the next call.
+ * @return int 1 if a byte was written, 0 if idle or not yet due, negative on a write error.
+ */
+int rotator_service(rotator_t *rot, struct timespec *next);
+
+#endif // ROTATOR_HPP
@@ -0,0 +1,79 @@
+/**
+ * @file rtloop.hpp
+ * @author Mit Bailey (mitbailey99@gmail.com)
+ * @brief Fixed-rate loop timing on absolute CLOCK_MONOTONIC deadlines, with overrun and jitter accounting.
+ * @version See Git tags for version information.
+ * @date 2026.10.18
+ *
+ * @copyright Copyright (c) 2021
+ *
+ */
+
+#ifndef RTLOOP_HPP
+#define RTLOOP_HPP
+
+#include <stdint.h>
+#include <time.h>
+
+typedef struct
+{
+    uint64_t cycles;
+    uint64_t overruns;  // Periods skipped because a cycle ran past the next deadline.
+    int64_t jitter_min; // Wake-up lateness, nanoseconds.
+    int64_t jitter_max;
+    double jitter_mean;
+    double jitter_m2; // Running sum of squared deviations, see rt_loop_jitter_stddev().
+} rt_loop_stats_t;
+
+typedef struct
+{
+    struct timespec deadline; // Next absolute deadline, CLOCK_MONOTONIC.
+    int64_t period;           // Nanoseconds.
+    rt_loop_stats_t stats;
+} rt_loop_t;
+
+/**
+ * @brief Starts the loop with its first deadline one period from now.
+ *
+ * @param loop
+ * @param rate_hz Cycles per second.
+ * @return int 1 on success, negative on failure.
+ */
+int rt_loop_init(rt_loop_t *loop, int rate_hz);
+
+/**
+ * @brief rt_loop_init() with the period given directly, e.g. a tracking period shortened for simulated time.
+ *
+ * @param loop
+ * @param period Nanoseconds.
+ * @return int 1 on success, negative on failure.
+ */
+int rt_loop_init_period(rt_loop_t *loop, int64_t period);
+
+/**
+ * @brief Sleeps until the next deadline (clock_nanosleep, TIMER_ABSTIME), records the wake-up lateness and
+ * advances the deadline. If the previous cycle overran, missed periods are skipped rather than run back to back.
+ *
+ * @param loop
+ * @return int Number of periods skipped (0 when on time).
+ */
+int rt_loop_wait(rt_loop_t *loop);
+
+/**
+ * @brief The accounting half of rt_loop_wait(), for loops woken by something else, e.g. a timerfd armed at
+ * loop->deadline with loop->period.
+ *
+ * @param loop
+ * @return int Number of periods skipped (0 when on time).
+ */
+int rt_loop_tick(rt_loop_t *loop);
+
+/**
+ * @brief Standard deviation of the wake-up lateness.
+ *
+ * @param stats
+ * @return double Nanoseconds.
+ */
+double rt_loop_jitter_stddev(const rt_loop_stats_t *stats);
+
+#endif // RTLOOP_HPP
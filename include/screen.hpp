@@ -0,0 +1,57 @@
+/**
+ * @file screen.hpp
+ * @author Mit Bailey (mitbailey99@gmail.com)
+ * @brief Catalog visibility screening: a two-body geometry prefilter ahead of SGP4 refinement.
+ * @version See Git tags for version information.
+ * @date 2026.10.18
+ *
+ * @copyright Copyright (c) 2021
+ *
+ */
+
+#ifndef SCREEN_HPP
+#define SCREEN_HPP
+
+#include <vector>
+#include "CoordGeodetic.h"
+#include "DateTime.h"
+#include "Observer.h"
+#include "OrbitalElements.h"
+#include "catalog.hpp"
+
+#define SCREEN_STEP_SEC 30         // SGP4 refinement step, seconds
+#define SCREEN_ALT_MARGIN 25.0     // Added to apogee for perturbations, kilometers
+#define SCREEN_ANGLE_MARGIN 1.0    // Added to every angular bound, degrees
+#define SCREEN_MAX_SYNC_INCL 60.0  // Longitude test only applied below this inclination, degrees
+
+/**
+ * @brief Conservative geometric visibility test on the mean elements.
+ *
+ * Rejects objects whose orbital plane never brings them within sight of the site (inclination too low for the
+ * site latitude at the apogee's coverage radius) and near-synchronous objects whose Keplerian ground track stays
+ * out of reach in longitude for the whole window. Never rejects an object that could rise above min_elev.
+ *
+ * @param elements
+ * @param site Observer location.
+ * @param min_elev Elevation mask, degrees.
+ * @param start Start of the window.
+ * @param window_min Window length, minutes.
+ * @return true The object may be visible and needs SGP4 refinement.
+ */
+bool screen_elements(const OrbitalElements &elements, const CoordGeodetic &site, double min_elev, const DateTime &start, double window_min);
+
+/**
+ * @brief Finds which catalog objects rise above min_elev during the window. Objects passing the prefilter are
+ * refined with position-only SGP4 at SCREEN_STEP_SEC.
+ *
+ * @param catalog
+ * @param dish
+ * @param min_elev Elevation mask, degrees.
+ * @param start Start of the window.
+ * @param window_min Window length, minutes.
+ * @param visible Receives the NORAD numbers of the visible objects.
+ * @return int Number of visible objects on success, negative on failure.
+ */
+int screen_catalog(const catalog_t *catalog, Observer *dish, double min_elev, const DateTime &start, double window_min, std::vector<unsigned int> &visible);
+
+#endif // SCREEN_HPP
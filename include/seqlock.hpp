@@ -0,0 +1,68 @@
+/**
+ * @file seqlock.hpp
+ * @author Mit Bailey (mitbailey99@gmail.com)
+ * @brief Single-writer sequence lock: readers never block the writer and retry on a torn copy.
+ * @version See Git tags for version information.
+ * @date 2026.10.18
+ *
+ * @copyright Copyright (c) 2021
+ *
+ */
+
+#ifndef SEQLOCK_HPP
+#define SEQLOCK_HPP
+
+#include <stdint.h>
+#include <atomic>
+
+typedef struct
+{
+    std::atomic<uint32_t> sequence; // Odd while a write is in progress. Zero-filled memory is a valid unlocked state.
+} seqlock_t;
+
+/**
+ * @brief Marks the protected data as being written. Only one writer may use a lock.
+ *
+ * @param lock
+ */
+static inline void seqlock_write_begin(seqlock_t *lock)
+{
+    lock->sequence.store(lock->sequence.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+}
+
+/**
+ * @brief Publishes the data written since seqlock_write_begin().
+ *
+ * @param lock
+ */
+static inline void seqlock_write_end(seqlock_t *lock)
+{
+    lock->sequence.store(lock->sequence.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+}
+
+/**
+ * @brief Starts a read, copy the data after this.
+ *
+ * @param lock
+ * @return uint32_t Pass to seqlock_read_retry().
+ */
+static inline uint32_t seqlock_read_begin(const seqlock_t *lock)
+{
+    return lock->sequence.load(std::memory_order_acquire);
+}
+
+/**
+ * @brief Checks the copy taken since seqlock_read_begin().
+ *
+ * @param lock
+ * @param start
+ * @return true The copy may be torn and has to be taken again.
+ */
+static inline bool seqlock_read_retry(const seqlock_t *lock, uint32_t start)
+{
+    std::atomic_thread_fence(std::memory_order_acquire);
+    return (start & 1) || lock->sequence.load(std::memory_order_relaxed) != start;
+}
+
+#endif // SEQLOCK_HPP
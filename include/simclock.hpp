@@ -0,0 +1,52 @@
+/**
+ * @file simclock.hpp
+ * @author Mit Bailey (mitbailey99@gmail.com)
+ * @brief Tracker time source: real time, or simulated time running faster than real time.
+ * @version See Git tags for version information.
+ * @date 2026.10.18
+ *
+ * @copyright Copyright (c) 2021
+ *
+ */
+
+#ifndef SIMCLOCK_HPP
+#define SIMCLOCK_HPP
+
+#include <stdint.h>
+#include "DateTime.h"
+
+#define SIMCLOCK_MAX_SCALE 1000.0
+
+/**
+ * @brief Starts simulated time. Without a call the clock is real time. Call before starting any thread that reads
+ * the clock, the state is not synchronized.
+ *
+ * @param scale Simulated seconds per real second, 1 to SIMCLOCK_MAX_SCALE.
+ * @param start Simulated UTC at the call.
+ * @return int 1 on success, negative on failure.
+ */
+int simclock_init(double scale, const DateTime &start);
+
+/**
+ * @brief Current UTC, simulated or real (DateTime::Now(true)).
+ *
+ * @return DateTime
+ */
+DateTime simclock_now();
+
+/**
+ * @brief Simulated seconds per real second, 1 in real time.
+ *
+ * @return double
+ */
+double simclock_scale();
+
+/**
+ * @brief Real (CLOCK_MONOTONIC) duration of a simulated duration, for timers and pacing.
+ *
+ * @param sim_ns Simulated nanoseconds.
+ * @return int64_t Real nanoseconds, at least 1.
+ */
+int64_t simclock_wall_ns(int64_t sim_ns);
+
+#endif // SIMCLOCK_HPP
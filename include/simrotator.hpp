@@ -0,0 +1,71 @@
+/**
+ * @file simrotator.hpp
+ * @author Mit Bailey (mitbailey99@gmail.com)
+ * @brief Virtual rotator controller behind a pseudo-terminal, so the tracker's serial path runs unchanged.
+ * @version See Git tags for version information.
+ * @date 2026.10.18
+ *
+ * @copyright Copyright (c) 2021
+ *
+ */
+
+#ifndef SIMROTATOR_HPP
+#define SIMROTATOR_HPP
+
+#include <pthread.h>
+#include <stdint.h>
+#include <time.h>
+#include <atomic>
+#include "kinematics.hpp"
+#include "rotator.hpp"
+
+#define SIM_ROTATOR_STEP 0.01 // simulated seconds per motion step
+
+typedef struct
+{
+    int master;      // Controller side of the pty.
+    int slave;       // Held open so the pty stays raw and the master does not hang up.
+    char devname[32]; // Tracker side of the pty, for open_connection().
+    pthread_t tid;
+    std::atomic<bool> running; // Cleared by sim_rotator_stop() from another thread.
+
+    pthread_mutex_t lock;
+    axis_model_t model[ROT_NUM_AXES];
+    axis_state_t axis[ROT_NUM_AXES]; // Controller degrees.
+    double target[ROT_NUM_AXES];
+    uint64_t commands;
+    uint64_t queries;
+
+    // Simulator thread only.
+    char rx[ROT_RX_SIZE];
+    int rx_len;
+    struct timespec last;
+} sim_rotator_t;
+
+/**
+ * @brief Opens the pty and starts the controller thread.
+ *
+ * @param sim
+ * @param az Starting azimuth, controller degrees.
+ * @param el Starting elevation, degrees.
+ * @return int 1 on success, negative on failure.
+ */
+int sim_rotator_start(sim_rotator_t *sim, double az, double el);
+
+/**
+ * @brief True dish position.
+ *
+ * @param sim
+ * @param az Controller degrees.
+ * @param el Degrees.
+ */
+void sim_rotator_position(sim_rotator_t *sim, double *az, double *el);
+
+/**
+ * @brief Stops the controller thread and closes the pty.
+ *
+ * @param sim
+ */
+void sim_rotator_stop(sim_rotator_t *sim);
+
+#endif // SIMROTATOR_HPP
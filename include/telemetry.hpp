@@ -0,0 +1,87 @@
+/**
+ * @file telemetry.hpp
+ * @author Mit Bailey (mitbailey99@gmail.com)
+ * @brief Batched binary tracking telemetry: timestamped pointing samples, several per frame.
+ * @version See Git tags for version information.
+ * @date 2026.10.18
+ *
+ * @copyright Copyright (c) 2021
+ *
+ */
+
+#ifndef TELEMETRY_HPP
+#define TELEMETRY_HPP
+
+#include <stdint.h>
+
+#define TELEM_RATE_HZ 5 // default samples per second, 0 disables the stream
+#define TELEM_RATE_MAX 10 // Hz
+#define TELEM_BATCH 5 // samples per frame
+#define TELEM_MAGIC 0x4d4c4554 // "TELM" little-endian
+#define TELEM_VERSION 1
+
+// Layout on the wire, host byte order like the AzEl frames.
+typedef struct __attribute__((packed))
+{
+    int64_t time_us;  // UTC, microseconds since the Unix epoch
+    float cmd_az;     // degrees, last command, 0 to 360
+    float cmd_el;     // degrees
+    float pred_az;    // degrees, SGP4 look angle at time_us, 0 to 360
+    float pred_el;    // degrees
+    float range;      // kilometers
+    float range_rate; // kilometers per second
+    uint8_t phase;    // track_phase_t
+    uint8_t reserved[3];
+} telem_sample_t;
+
+typedef struct __attribute__((packed))
+{
+    uint32_t magic;
+    uint16_t version;
+    uint8_t count; // Samples that follow.
+    uint8_t reserved;
+    uint32_t sequence; // Frames sent, gaps show frames lost on the link.
+    telem_sample_t samples[TELEM_BATCH];
+} telem_frame_t;
+
+typedef struct
+{
+    int rate_hz;
+    uint32_t sequence;
+    telem_frame_t frame; // Batch being filled, serialized in place.
+} telem_t;
+
+/**
+ * @brief Prepares an empty batch.
+ *
+ * @param telem
+ * @param rate_hz Samples per second, 0 to TELEM_RATE_MAX.
+ * @return int 1 on success, negative on failure.
+ */
+int telem_init(telem_t *telem, int rate_hz);
+
+/**
+ * @brief Appends a sample to the batch.
+ *
+ * @param telem
+ * @param sample
+ * @return true The batch is full and should be sent.
+ */
+bool telem_push(telem_t *telem, const telem_sample_t *sample);
+
+/**
+ * @brief Bytes of the current batch on the wire, header included.
+ *
+ * @param telem
+ * @return int
+ */
+int telem_size(const telem_t *telem);
+
+/**
+ * @brief Starts the next batch once the current one was sent (or dropped).
+ *
+ * @param telem
+ */
+void telem_next(telem_t *telem);
+
+#endif // TELEMETRY_HPP
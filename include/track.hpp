@@ -12,8 +12,21 @@
 #ifndef TRACK_HPP
 #define TRACK_HPP
 
+#include <signal.h>
 #include "CoordTopocentric.h"
+#include "Observer.h"
+#include "SGP4.h"
 #include "network.hpp"
+#include "catalog.hpp"
+#include "evloop.hpp"
+#include "flightrec.hpp"
+#include "netstats.hpp"
+#include "pass.hpp"
+#include "rotator.hpp"
+#include "rtloop.hpp"
+#include "simrotator.hpp"
+#include "telemetry.hpp"
+#include "trackshm.hpp"
 
 #define SERVER_PORT 52040
 
@@ -25,6 +38,24 @@
 #define MIN_ELEV 10.0 // degrees
 #define ELEV_ADJ 0 // degrees adjustment +-
 #define AZIM_ADJ -34 // degrees adjustment +-
+#define TRACK_RATE_HZ 1 // default pointing update rate
+#define TRACK_RATE_MAX 50 // Hz
+#define TRACK_STATS_INTERVAL 60 // seconds between loop timing reports
+#define POINT_TOLERANCE 1.0 // degrees of measured pointing error before a command is resent
+#define TRACK_STATUS_INTERVAL 10 // seconds between position reports to the server
+#define TRACK_HOUSEKEEPING_INTERVAL 1 // seconds between shutdown and network socket checks
+#define TRACK_OVERRIDE_HOLD 30 // seconds an operator command holds off autotrack
+#define TRACK_RX_BATCH 8 // frames handled per network wake-up
+#define TRACK_RX_PAYLOAD_SIZE 0x100 // bytes, largest payload accepted from the server
+
+typedef enum
+{
+    TRACK_IDLE,        // No pass within the lookahead.
+    TRACK_PREPOSITION, // Waiting at the rise point.
+    TRACK_PASS,        // Following the satellite.
+    TRACK_PARKING,     // Returning to park after a pass.
+    TRACK_MANUAL       // Holding an operator command, autotrack suspended.
+} track_phase_t;
 
 typedef struct
 {
@@ -33,11 +64,73 @@ typedef struct
     NetDataClient *network_data;
     uint8_t netstat;
     char devname[32];
-    double AzEl[2]; // Azimuth, Elevation
+    track_snapshot_t state; // Latest tracking cycle, event loop only (trackshm serves other processes).
     int connection;
     bool resetAtInit;
+    volatile sig_atomic_t done; // Set on SIGINT/SIGTERM, the only thing that ends tracking.
+    int track_rate_hz;
+    int telem_rate_hz; // Telemetry samples per second, 0 disables the stream.
+    bool rotator_feedback; // Query the controller for its position, see format_query(). Off by default.
+    rt_loop_stats_t track_stats; // Tracking loop timing, updated every cycle.
+    rotator_t rotator[1];
+    netstats_t netstats[1]; // Link counters, updated on the event loop only.
+    sim_rotator_t *sim; // Virtual rotator behind devname, nullptr when driving real hardware.
+    const char *flightrec_path; // Flight recorder file from -R, nullptr (the default) disables it.
+    const char *catalog_path; // TLE or OMM catalog from -c, re-read when it changes; nullptr keeps the built-in TLE.
 } global_data_t;
 
+typedef struct
+{
+    SGP4 *target;       // Own copy of the catalog entry's model, so it outlives the satellite's removal.
+    unsigned int norad; // Of target.
+    catalog_t *catalog; // Source of target's elements, starting with the built-in TLE.
+    Observer *dish;
+    bool pending_az;
+    bool pending_el;
+    bool sat_viewable;
+    track_phase_t phase;
+    DateTime time;         // Of the last track_step().
+    double sat_az;         // degrees, satellite look angle at time, 0 to 360
+    double sat_el;         // degrees
+    double sat_range_rate; // kilometers per second
+    Eci sat_eci;           // Target state at time when track_step() propagated it, see track_record().
+    bool override;                  // An operator command is holding off autotrack.
+    struct timespec override_until; // CLOCK_MONOTONIC end of the hold.
+    track_phase_t override_phase;   // Phase to return to when the hold ends.
+    double cmd_az; // degrees, on the cable wrap
+    double cmd_el; // degrees, elevation axis (past 90 in a flipped pass)
+    int sleep_timer; // cycles
+    int sleep_timer_max;
+    uint32_t target_generation; // Changes whenever target gets new elements, invalidating the pass table.
+    pass_t pass[1];
+    double error_sum; // degrees, pointing error of the simulated dish over the current pass
+    double error_max;
+    uint64_t error_samples;
+    flightrec_gpio_t gpio[FLIGHTREC_GPIO_MAX]; // GPIO transitions of the last track_step().
+    int gpio_count;
+    int gpio_dropped;
+} track_state_t;
+
+typedef struct
+{
+    global_data_t *global;
+    track_state_t state[1];
+    rt_loop_t loop[1];
+    ev_loop_t ev[1];
+    int track_timer;        // timerfd at track_rate_hz
+    int rotator_timer;      // timerfd, one-shot at the next paced command byte
+    int status_timer;       // timerfd, every TRACK_STATUS_INTERVAL
+    int housekeeping_timer; // timerfd, every TRACK_HOUSEKEEPING_INTERVAL
+    int telem_timer;        // timerfd at telem_rate_hz, -1 when disabled
+    telem_t telem[1];
+    trackshm_t shm[1]; // Snapshot published every tracking cycle.
+    flightrec_t rec[1]; // Record of every tracking cycle, unmapped when disabled.
+    int stats_timer;        // timerfd, every NETSTATS_INTERVAL
+    int stats_socket;       // Listening NETSTATS_SOCKET, -1 if unavailable.
+    int net_fd;             // Watched network socket, -1 if none.
+    struct timespec catalog_mtime; // Of global_data_t::catalog_path when last read.
+} track_loop_t;
+
 /**
  * @brief Two line element of the ISS.
  * 
@@ -63,6 +156,58 @@ const char TLE[2][70] = {"1 49278U 98067SX  21323.34441057  .00027466  00000-0
  */
 int open_connection(char *devname);
 
+/**
+ * @brief Places an azimuth on the cable wrap. Angles already inside the mechanical range are kept, others are
+ * moved by whole turns onto the lowest wrap that fits.
+ * 
+ * @param azimuth Degrees.
+ * @return double Degrees, AZIM_ADJ + result is within ROT_AZ_MIN to ROT_AZ_MAX.
+ */
+double azimuth_to_wrap(double azimuth);
+
+/**
+ * @brief Builds the controller command for an azimuth on the wrap, applying AZIM_ADJ.
+ * 
+ * @param command 
+ * @param size 
+ * @param azimuth Degrees.
+ * @return int Length of the command.
+ */
+int format_azimuth(char *command, int size, double azimuth);
+
+/**
+ * @brief Builds the controller command for an elevation.
+ * 
+ * @param command 
+ * @param size 
+ * @param elevation Degrees.
+ * @return int Length of the command.
+ */
+int format_elevation(char *command, int size, double elevation);
+
+/**
+ * @brief Builds the controller's position query for an axis. The read-back syntax is not confirmed for the
+ * station's controller, so queries are only sent with global_data_t::rotator_feedback (main's -f, or the simulated
+ * rotator).
+ * 
+ * @param command 
+ * @param size 
+ * @param axis 
+ * @return int Length of the command.
+ */
+int format_query(char *command, int size, rot_axis_t axis);
+
+/**
+ * @brief Parses a position report line ("PB nnn" or "PA nnn", controller degrees), removing AZIM_ADJ. The azimuth
+ * stays on the cable wrap and so may be outside 0 to 360.
+ * 
+ * @param reply One line, without the line ending.
+ * @param axis 
+ * @param angle Degrees.
+ * @return int 1 on success, negative if the line is not a position report.
+ */
+int parse_position(const char *reply, rot_axis_t *axis, double *angle);
+
 /**
  * @brief 
  * 
@@ -91,25 +236,103 @@ int aim_elevation(int connection, double elevation);
 CoordTopocentric find_next_targetrise(SGP4 *model, Observer *dish);
 
 /**
- * @brief 
+ * @brief Sets up the target, observer and pointing state for track_step(). The target is taken from a catalog
+ * holding the built-in TLE, and follows that satellite's entry through later catalog updates.
  * 
- * @param args 
- * @return void* 
+ * @param state 
  */
-void *tracking_thread(void *args);
+void track_init(track_state_t *state);
 
 /**
- * @brief 
+ * @brief One tracking cycle: propagates the target and decides which axes need a new command.
  * 
- * @param args 
- * @return void* 
+ * @param global 
+ * @param state 
+ */
+void track_step(global_data_t *global, track_state_t *state);
+
+/**
+ * @brief Queues the commands decided by track_step() on the rotator writer.
+ * 
+ * @param global 
+ * @param state 
+ * @return true An axis was commanded, the new position should be reported.
+ */
+bool track_execute(global_data_t *global, track_state_t *state);
+
+/**
+ * @brief Sends the measured AzEl of global->state to the server, falling back to the commanded
+ * angles without fresh feedback.
+ * 
+ * @param global 
+ */
+void track_send_status(global_data_t *global);
+
+/**
+ * @brief Collects the tracking state after a cycle: commanded and measured dish position and the satellite's
+ * look angle, all off the cable wrap.
+ * 
+ * @param global 
+ * @param state 
+ * @param cycle Tracking cycle count.
+ * @param snapshot 
+ */
+void track_snapshot(global_data_t *global, const track_state_t *state, uint64_t cycle, track_snapshot_t *snapshot);
+
+/**
+ * @brief Fills a flight recorder record for the cycle just run, propagating the target at the cycle time if
+ * track_step() took the look angle from the pass table.
+ * 
+ * @param global 
+ * @param state 
+ * @param snapshot The cycle's snapshot from track_snapshot().
+ * @param record 
+ */
+void track_record(global_data_t *global, track_state_t *state, const track_snapshot_t *snapshot, flightrec_record_t *record);
+
+/**
+ * @brief Sends one frame to the server from a NetFrame on the stack. The NetFrame still allocates its own payload
+ * buffer inside the network library, so a send is not allocation-free. Called from the event loop only.
+ * 
+ * @param global 
+ * @param type 
+ * @param payload Serialized payload, e.g. a packed struct on the caller's stack.
+ * @param size Bytes.
+ * @return ssize_t Bytes sent, negative on failure.
  */
-void *gs_network_rx_thread(void *args);
+ssize_t track_send_frame(global_data_t *global, NetType type, const void *payload, int size);
 
 /**
- * @brief Periodically sends X-Band status updates.
+ * @brief Points the dish at an operator's az/el ahead of any autotrack command and suspends autotrack for
+ * TRACK_OVERRIDE_HOLD. A new command restarts the hold.
  * 
+ * @param global 
+ * @param state 
+ * @param az Degrees, 0 to 360.
+ * @param el Degrees, 0 to 90.
+ * @param received CLOCK_MONOTONIC time the command arrived.
+ * @return int 1 on success, negative if the angles are out of range.
+ */
+int track_override(global_data_t *global, track_state_t *state, double az, double el, const struct timespec *received);
+
+/**
+ * @brief Acts on a frame received from the server.
+ * 
+ * @param global 
+ * @param state 
+ * @param netframe 
+ * @param received CLOCK_MONOTONIC time the frame was read.
+ */
+void track_handle_frame(global_data_t *global, track_state_t *state, NetFrame *netframe, const struct timespec *received);
+
+/**
+ * @brief Opens the dish controller, then runs tracking, rotator pacing, status reports and network receive on a
+ * single epoll loop until global->done is set. Runs once per process: the server link coming and going only changes
+ * which socket the loop watches.
+ * 
+ * @param args global_data_t *
+ * @return void* 
  */
-void *track_status_thread(void *args);
+void *track_event_thread(void *args);
 
 #endif // TRACK_HPP
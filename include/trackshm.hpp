@@ -0,0 +1,101 @@
+/**
+ * @file trackshm.hpp
+ * @author Mit Bailey (mitbailey99@gmail.com)
+ * @brief Tracking state published in POSIX shared memory for local processes (Doppler control, displays).
+ * @version See Git tags for version information.
+ * @date 2026.10.18
+ *
+ * @copyright Copyright (c) 2021
+ *
+ */
+
+#ifndef TRACKSHM_HPP
+#define TRACKSHM_HPP
+
+#include <stdint.h>
+#include "seqlock.hpp"
+
+#define TRACKSHM_NAME "/gs_track"
+#define TRACKSHM_MAGIC 0x4b435254 // "TRCK" little-endian
+#define TRACKSHM_VERSION 1
+#define TRACKSHM_READ_TRIES 64 // torn copies a reader retries before giving up
+
+#define TRACKSHM_AZ_MEASURED 0x1 // az is fresh rotator feedback rather than the command
+#define TRACKSHM_EL_MEASURED 0x2
+
+typedef struct
+{
+    int64_t time_us;   // UTC of the tracking cycle, microseconds since the Unix epoch
+    uint64_t cycle;    // Tracking cycles since start.
+    uint32_t norad;    // Target.
+    uint8_t phase;     // track_phase_t
+    uint8_t flags;     // TRACKSHM_*_MEASURED
+    uint16_t reserved;
+    double cmd_az;     // degrees, last command, 0 to 360
+    double cmd_el;     // degrees
+    double az;         // degrees, dish position, 0 to 360
+    double el;         // degrees
+    double sat_az;     // degrees, satellite look angle, 0 to 360
+    double sat_el;     // degrees
+    double range_rate; // kilometers per second
+} track_snapshot_t;
+
+typedef struct
+{
+    uint32_t magic;
+    uint32_t version;
+    seqlock_t lock;
+    track_snapshot_t snapshot;
+} trackshm_segment_t;
+
+typedef struct
+{
+    int fd;
+    trackshm_segment_t *segment; // nullptr when not mapped.
+    bool writer;
+} trackshm_t;
+
+/**
+ * @brief Creates (or takes over) and maps the segment for publishing.
+ *
+ * @param shm
+ * @param name POSIX shared memory name, e.g. TRACKSHM_NAME.
+ * @return int 1 on success, negative on failure.
+ */
+int trackshm_create(trackshm_t *shm, const char *name);
+
+/**
+ * @brief Maps an existing segment read-only.
+ *
+ * @param shm
+ * @param name
+ * @return int 1 on success, negative if the tracker has not created it or the layout differs.
+ */
+int trackshm_attach(trackshm_t *shm, const char *name);
+
+/**
+ * @brief Publishes a snapshot. Never waits on readers.
+ *
+ * @param shm
+ * @param snapshot
+ */
+void trackshm_publish(trackshm_t *shm, const track_snapshot_t *snapshot);
+
+/**
+ * @brief Copies the latest consistent snapshot.
+ *
+ * @param shm
+ * @param snapshot
+ * @return true A consistent copy was taken within TRACKSHM_READ_TRIES.
+ */
+bool trackshm_read(const trackshm_t *shm, track_snapshot_t *snapshot);
+
+/**
+ * @brief Unmaps the segment. The writer also removes the name.
+ *
+ * @param shm
+ * @param name
+ */
+void trackshm_close(trackshm_t *shm, const char *name);
+
+#endif // TRACKSHM_HPP
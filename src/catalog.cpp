@@ -0,0 +1,312 @@
+/**
+ * @file catalog.cpp
+ * @author Mit Bailey (mitbailey99@gmail.com)
+ * @brief
+ * @version See Git tags for version information.
+ * @date 2026.10.18
+ *
+ * @copyright Copyright (c) 2021
+ *
+ */
+
+#include <string.h>
+#include <string>
+#include "OmmReader.h"
+#include "Tle.h"
+#include "meb_debug.h"
+#include "catalog.hpp"
+
+#define FNV_OFFSET 0xcbf29ce484222325ULL
+#define FNV_PRIME 0x100000001b3ULL
+
+static uint64_t fnv1a(uint64_t hash, const void *data, size_t len)
+{
+    const uint8_t *bytes = (const uint8_t *)data;
+    for (size_t i = 0; i < len; i++)
+    {
+        hash ^= bytes[i];
+        hash *= FNV_PRIME;
+    }
+    return hash;
+}
+
+static uint64_t omm_fingerprint(const Omm &omm)
+{
+    const double fields[] = {omm.MeanMotion(), omm.Eccentricity(), omm.Inclination(true), omm.RightAscendingNode(true),
+                             omm.ArgumentPerigee(true), omm.MeanAnomaly(true), omm.BStar()};
+    int64_t ticks = omm.Epoch().Ticks();
+
+    uint64_t hash = fnv1a(FNV_OFFSET, fields, sizeof(fields));
+    return fnv1a(hash, &ticks, sizeof(ticks));
+}
+
+static uint64_t tle_fingerprint(const Tle &tle)
+{
+    std::string line1 = tle.Line1();
+    std::string line2 = tle.Line2();
+
+    uint64_t hash = fnv1a(FNV_OFFSET, line1.data(), line1.size());
+    return fnv1a(hash, line2.data(), line2.size());
+}
+
+static void catalog_begin(catalog_t *catalog)
+{
+    catalog->changes.clear();
+    for (auto &it : catalog->entries)
+    {
+        it.second.seen = false;
+    }
+}
+
+/**
+ * @brief Adds or refreshes one record. The model is only re-initialized when the fingerprint differs.
+ *
+ * @tparam T Tle or Omm.
+ * @return true The record was applied (or was unchanged), false if its elements were rejected.
+ */
+template <typename T>
+static bool catalog_apply(catalog_t *catalog, const T &record, uint64_t fingerprint)
+{
+    unsigned int norad = record.NoradNumber();
+    auto it = catalog->entries.find(norad);
+
+    if (it != catalog->entries.end())
+    {
+        catalog_entry_t *entry = &it->second;
+        entry->seen = true;
+
+        if (entry->fingerprint == fingerprint && entry->epoch == record.Epoch())
+        {
+            return true; // Unchanged.
+        }
+
+        // SetElements() resets the model before it can throw, so the new model is built aside and only copied over
+        // (keeping the pointer cached by passes) once it initialized.
+        try
+        {
+            SGP4 candidate{OrbitalElements(record)};
+            *entry->model = candidate;
+        }
+        catch (SatelliteException &e)
+        {
+            dbprintlf(RED_FG "Keeping previous elements for %u: %s", norad, e.what());
+            return false;
+        }
+
+        entry->epoch = record.Epoch();
+        entry->fingerprint = fingerprint;
+        entry->generation++;
+        catalog->changes.push_back({norad, CATALOG_UPDATED, entry->generation});
+        return true;
+    }
+
+    SGP4 *model = nullptr;
+    try
+    {
+        model = new SGP4(OrbitalElements(record));
+    }
+    catch (SatelliteException &e)
+    {
+        dbprintlf(RED_FG "Skipping %u: %s", norad, e.what());
+        return false;
+    }
+
+    catalog_entry_t entry;
+    entry.model = model;
+    entry.epoch = record.Epoch();
+    entry.fingerprint = fingerprint;
+    entry.generation = 1;
+    entry.seen = true;
+    catalog->entries.emplace(norad, entry);
+    catalog->changes.push_back({norad, CATALOG_ADDED, entry.generation});
+    return true;
+}
+
+/**
+ * @brief Removes satellites absent from the update and publishes the change list.
+ *
+ * @param records Number of records applied. A pull with none is treated as a failed download and leaves the catalog
+ * intact.
+ * @param rejected Number of records that could not be read or whose elements were rejected.
+ */
+static int catalog_finish(catalog_t *catalog, int records, int rejected)
+{
+    if (records == 0)
+    {
+        dbprintlf(RED_FG "Catalog update contained no usable records, ignoring.");
+        return -1;
+    }
+
+    for (auto it = catalog->entries.begin(); it != catalog->entries.end();)
+    {
+        if (it->second.seen)
+        {
+            it++;
+            continue;
+        }
+
+        catalog->changes.push_back({it->first, CATALOG_REMOVED, it->second.generation + 1});
+        delete it->second.model;
+        it = catalog->entries.erase(it);
+    }
+
+    if (catalog->changes.size() > 0)
+    {
+        for (int i = 0; i < catalog->num_subscribers; i++)
+        {
+            catalog->subscribers[i](catalog->changes, catalog->subscriber_ctx[i]);
+        }
+    }
+
+    dbprintlf(BLUE_FG "Catalog holds %zu satellites, %d records applied, %d rejected, %zu changed.", catalog->entries.size(), records, rejected, catalog->changes.size());
+
+    return catalog->changes.size();
+}
+
+int catalog_subscribe(catalog_t *catalog, catalog_callback_t callback, void *ctx)
+{
+    if (catalog == nullptr || callback == nullptr)
+    {
+        dbprintlf(RED_FG "Invalid subscription.");
+        return -1;
+    }
+
+    if (catalog->num_subscribers >= CATALOG_MAX_SUBSCRIBERS)
+    {
+        dbprintlf(RED_FG "Too many catalog subscribers.");
+        return -1;
+    }
+
+    catalog->subscribers[catalog->num_subscribers] = callback;
+    catalog->subscriber_ctx[catalog->num_subscribers] = ctx;
+    catalog->num_subscribers++;
+
+    return 1;
+}
+
+int catalog_update_omm(catalog_t *catalog, std::istream &stream)
+{
+    if (catalog == nullptr)
+    {
+        dbprintlf(RED_FG "Catalog null.");
+        return -1;
+    }
+
+    catalog_begin(catalog);
+
+    OmmReader reader(stream);
+    Omm omm;
+    int records = 0;
+    int rejected = 0;
+    for (;;)
+    {
+        try
+        {
+            if (!reader.Next(omm))
+            {
+                break;
+            }
+        }
+        catch (OmmException &e)
+        {
+            dbprintlf(RED_FG "Bad OMM record near line %lu: %s", reader.LineNumber(), e.what());
+            rejected++;
+            if (stream.eof())
+            {
+                break;
+            }
+            continue;
+        }
+
+        if (catalog_apply(catalog, omm, omm_fingerprint(omm)))
+        {
+            records++;
+        }
+        else
+        {
+            rejected++;
+        }
+    }
+
+    return catalog_finish(catalog, records, rejected);
+}
+
+int catalog_update_tle(catalog_t *catalog, std::istream &stream)
+{
+    if (catalog == nullptr)
+    {
+        dbprintlf(RED_FG "Catalog null.");
+        return -1;
+    }
+
+    catalog_begin(catalog);
+
+    std::string line, line1;
+    int records = 0;
+    int rejected = 0;
+    while (std::getline(stream, line))
+    {
+        if (line.size() > 0 && line[line.size() - 1] == '\r')
+        {
+            line.erase(line.size() - 1);
+        }
+
+        if (line.compare(0, 2, "1 ") == 0)
+        {
+            line1 = line;
+            continue;
+        }
+
+        if (line.compare(0, 2, "2 ") != 0 || line1.empty())
+        {
+            continue; // Name line or stray text.
+        }
+
+        try
+        {
+            Tle tle(line1, line);
+            if (catalog_apply(catalog, tle, tle_fingerprint(tle)))
+            {
+                records++;
+            }
+            else
+            {
+                rejected++;
+            }
+        }
+        catch (TleException &e)
+        {
+            dbprintlf(RED_FG "Bad TLE: %s", e.what());
+            rejected++;
+        }
+        line1.clear();
+    }
+
+    return catalog_finish(catalog, records, rejected);
+}
+
+const catalog_entry_t *catalog_find(const catalog_t *catalog, unsigned int norad)
+{
+    auto it = catalog->entries.find(norad);
+    if (it == catalog->entries.end())
+    {
+        return nullptr;
+    }
+    return &it->second;
+}
+
+bool catalog_is_current(const catalog_t *catalog, unsigned int norad, uint32_t generation)
+{
+    const catalog_entry_t *entry = catalog_find(catalog, norad);
+    return entry != nullptr && entry->generation == generation;
+}
+
+void catalog_destroy(catalog_t *catalog)
+{
+    for (auto &it : catalog->entries)
+    {
+        delete it.second.model;
+    }
+    catalog->entries.clear();
+    catalog->changes.clear();
+}
@@ -0,0 +1,173 @@
+/**
+ * @file evloop.cpp
+ * @author Mit Bailey (mitbailey99@gmail.com)
+ * @brief
+ * @version See Git tags for version information.
+ * @date 2026.10.18
+ *
+ * @copyright Copyright (c) 2021
+ *
+ */
+
+#include <errno.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/timerfd.h>
+#include "meb_debug.h"
+#include "evloop.hpp"
+
+#define NSEC_PER_SEC 1000000000LL
+
+int ev_loop_init(ev_loop_t *ev)
+{
+    if (ev == nullptr)
+    {
+        return -1;
+    }
+
+    ev->epfd = epoll_create1(EPOLL_CLOEXEC);
+    if (ev->epfd < 0)
+    {
+        dbprintlf(RED_FG "Could not create epoll instance, error %d.", errno);
+        return -1;
+    }
+
+    for (int i = 0; i < EV_MAX_SOURCES; i++)
+    {
+        ev->sources[i].fd = -1;
+    }
+    ev->running = true;
+
+    return 1;
+}
+
+int ev_add(ev_loop_t *ev, int fd, uint32_t events, ev_handler_t handler, void *ctx)
+{
+    ev_source_t *src = nullptr;
+    for (int i = 0; i < EV_MAX_SOURCES; i++)
+    {
+        if (ev->sources[i].fd < 0)
+        {
+            src = &ev->sources[i];
+            break;
+        }
+    }
+    if (src == nullptr)
+    {
+        dbprintlf(RED_FG "No free event source for fd %d.", fd);
+        return -1;
+    }
+
+    struct epoll_event event;
+    memset(&event, 0, sizeof(event));
+    event.events = events;
+    event.data.ptr = src;
+    if (epoll_ctl(ev->epfd, EPOLL_CTL_ADD, fd, &event) < 0)
+    {
+        dbprintlf(RED_FG "Could not watch fd %d, error %d.", fd, errno);
+        return -1;
+    }
+
+    src->fd = fd;
+    src->handler = handler;
+    src->ctx = ctx;
+
+    return 1;
+}
+
+int ev_remove(ev_loop_t *ev, int fd)
+{
+    for (int i = 0; i < EV_MAX_SOURCES; i++)
+    {
+        if (ev->sources[i].fd == fd)
+        {
+            // The slot is freed even if the fd was already closed (and so dropped by epoll).
+            ev->sources[i].fd = -1;
+            epoll_ctl(ev->epfd, EPOLL_CTL_DEL, fd, NULL);
+            return 1;
+        }
+    }
+    return -1;
+}
+
+int ev_loop_run(ev_loop_t *ev)
+{
+    struct epoll_event events[EV_MAX_EVENTS];
+
+    while (ev->running)
+    {
+        int num_events = epoll_wait(ev->epfd, events, EV_MAX_EVENTS, -1);
+        if (num_events < 0)
+        {
+            if (errno == EINTR)
+            {
+                continue;
+            }
+            dbprintlf(FATAL "epoll_wait failed, error %d.", errno);
+            return -1;
+        }
+
+        for (int i = 0; i < num_events && ev->running; i++)
+        {
+            ev_source_t *src = (ev_source_t *)events[i].data.ptr;
+            // Removed by an earlier handler in this batch.
+            if (src->fd < 0)
+            {
+                continue;
+            }
+            src->handler(src->fd, events[i].events, src->ctx);
+        }
+    }
+
+    return 1;
+}
+
+void ev_loop_destroy(ev_loop_t *ev)
+{
+    close(ev->epfd);
+    ev->epfd = -1;
+}
+
+int ev_timer_create(void)
+{
+    int tfd = timerfd_create(CLOCK_MONOTONIC, TFD_NONBLOCK | TFD_CLOEXEC);
+    if (tfd < 0)
+    {
+        dbprintlf(RED_FG "Could not create timer, error %d.", errno);
+    }
+    return tfd;
+}
+
+int ev_timer_arm(int tfd, const struct timespec *deadline, int64_t period)
+{
+    struct itimerspec spec;
+    memset(&spec, 0, sizeof(spec));
+    if (deadline != nullptr)
+    {
+        spec.it_value = *deadline;
+        // A zero it_value would disarm instead of firing.
+        if (spec.it_value.tv_sec == 0 && spec.it_value.tv_nsec == 0)
+        {
+            spec.it_value.tv_nsec = 1;
+        }
+        spec.it_interval.tv_sec = period / NSEC_PER_SEC;
+        spec.it_interval.tv_nsec = period % NSEC_PER_SEC;
+    }
+
+    if (timerfd_settime(tfd, TFD_TIMER_ABSTIME, &spec, NULL) < 0)
+    {
+        dbprintlf(RED_FG "Could not arm timer, error %d.", errno);
+        return -1;
+    }
+    return 1;
+}
+
+uint64_t ev_timer_read(int tfd)
+{
+    uint64_t expirations = 0;
+    if (read(tfd, &expirations, sizeof(expirations)) != sizeof(expirations))
+    {
+        return 0;
+    }
+    return expirations;
+}
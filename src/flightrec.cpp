@@ -0,0 +1,191 @@
+/**
+ * @file flightrec.cpp
+ * @author Mit Bailey (mitbailey99@gmail.com)
+ * @brief
+ * @version See Git tags for version information.
+ * @date 2026.10.18
+ *
+ * @copyright Copyright (c) 2021
+ *
+ */
+
+#include <errno.h>
+#include <fcntl.h>
+#include <inttypes.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/statvfs.h>
+#include <unistd.h>
+#include "meb_debug.h"
+#include "flightrec.hpp"
+
+static bool flightrec_map(flightrec_t *rec, size_t size, int prot)
+{
+    void *map = mmap(NULL, size, prot, MAP_SHARED, rec->fd, 0);
+    if (map == MAP_FAILED)
+    {
+        return false;
+    }
+    rec->size = size;
+    rec->header = (flightrec_header_t *)map;
+    rec->records = (flightrec_record_t *)((char *)map + FLIGHTREC_HEADER_SIZE);
+    return true;
+}
+
+int flightrec_open(flightrec_t *rec, const char *path, uint32_t capacity)
+{
+    rec->header = nullptr;
+    rec->writer = true;
+
+    rec->fd = open(path, O_RDWR | O_CREAT, 0644);
+    if (rec->fd < 0)
+    {
+        dbprintlf(RED_FG "Could not open flight recorder %s, error %d.", path, errno);
+        return -1;
+    }
+
+    size_t size = FLIGHTREC_HEADER_SIZE + (size_t)capacity * sizeof(flightrec_record_t);
+
+    // Checked before growing the file, where ftruncate() would leave a sparse file to fault on later.
+    struct stat st;
+    struct statvfs fs;
+    if (fstat(rec->fd, &st) == 0 && (size_t)st.st_size < size && fstatvfs(rec->fd, &fs) == 0 && (uint64_t)fs.f_bavail * fs.f_frsize < size - st.st_size)
+    {
+        dbprintlf(RED_FG "Not enough free space for flight recorder %s: %zu bytes needed, %llu available.", path, size - (size_t)st.st_size, (unsigned long long)fs.f_bavail * fs.f_frsize);
+        close(rec->fd);
+        return -1;
+    }
+
+    int err = posix_fallocate(rec->fd, 0, size);
+    if (err != 0 && err != EOPNOTSUPP && err != EINVAL)
+    {
+        dbprintlf(RED_FG "Could not reserve %zu bytes for flight recorder %s, error %d.", size, path, err);
+        close(rec->fd);
+        return -1;
+    }
+    if ((err != 0 && ftruncate(rec->fd, size) < 0) || !flightrec_map(rec, size, PROT_READ | PROT_WRITE))
+    {
+        dbprintlf(RED_FG "Could not map flight recorder %s, error %d.", path, errno);
+        close(rec->fd);
+        return -1;
+    }
+    madvise(rec->records, size - FLIGHTREC_HEADER_SIZE, MADV_SEQUENTIAL);
+
+    flightrec_header_t *header = rec->header;
+    if (header->magic == FLIGHTREC_MAGIC && header->version == FLIGHTREC_VERSION && header->record_size == sizeof(flightrec_record_t) && header->capacity == capacity && header->next > 0)
+    {
+        dbprintlf(GREEN_FG "Flight recorder %s continuing at record %" PRIu64 ".", path, header->next);
+        return 1;
+    }
+
+    // A file of another layout (or a new one) starts over. It is truncated first so stale records cannot be
+    // mistaken for new ones.
+    header->magic = 0;
+    memset(rec->records, 0, size - FLIGHTREC_HEADER_SIZE);
+    header->version = FLIGHTREC_VERSION;
+    header->record_size = sizeof(flightrec_record_t);
+    header->capacity = capacity;
+    header->next = 1;
+    __atomic_store_n(&header->magic, FLIGHTREC_MAGIC, __ATOMIC_RELEASE);
+    dbprintlf(GREEN_FG "Flight recorder %s started, %u records.", path, capacity);
+
+    return 1;
+}
+
+int flightrec_attach(flightrec_t *rec, const char *path)
+{
+    rec->header = nullptr;
+    rec->writer = false;
+
+    rec->fd = open(path, O_RDONLY);
+    if (rec->fd < 0)
+    {
+        return -1;
+    }
+
+    struct stat st;
+    if (fstat(rec->fd, &st) < 0 || st.st_size < FLIGHTREC_HEADER_SIZE || !flightrec_map(rec, st.st_size, PROT_READ))
+    {
+        close(rec->fd);
+        return -1;
+    }
+
+    flightrec_header_t *header = rec->header;
+    if (__atomic_load_n(&header->magic, __ATOMIC_ACQUIRE) != FLIGHTREC_MAGIC || header->version != FLIGHTREC_VERSION || header->record_size != sizeof(flightrec_record_t) ||
+        FLIGHTREC_HEADER_SIZE + (size_t)header->capacity * sizeof(flightrec_record_t) > rec->size)
+    {
+        flightrec_close(rec);
+        return -1;
+    }
+    return 1;
+}
+
+void flightrec_write(flightrec_t *rec, flightrec_record_t *record)
+{
+    if (rec->header == nullptr)
+    {
+        return;
+    }
+
+    // The slot reads as unused while it is being written, so a reader never takes a half-written record.
+    uint64_t sequence = rec->header->next;
+    flightrec_record_t *slot = &rec->records[(sequence - 1) % rec->header->capacity];
+    __atomic_store_n(&slot->sequence, 0, __ATOMIC_RELAXED);
+    __atomic_thread_fence(__ATOMIC_RELEASE);
+
+    record->sequence = 0;
+    memcpy(slot, record, sizeof(flightrec_record_t));
+    record->sequence = sequence;
+
+    __atomic_store_n(&slot->sequence, sequence, __ATOMIC_RELEASE);
+    __atomic_store_n(&rec->header->next, sequence + 1, __ATOMIC_RELEASE);
+}
+
+uint64_t flightrec_range(const flightrec_t *rec, uint64_t *first)
+{
+    if (rec->header == nullptr)
+    {
+        *first = 1;
+        return 0;
+    }
+
+    uint64_t next = __atomic_load_n(&rec->header->next, __ATOMIC_ACQUIRE);
+    uint64_t count = next - 1 < rec->header->capacity ? next - 1 : rec->header->capacity;
+    *first = next - count;
+    return count;
+}
+
+bool flightrec_read(const flightrec_t *rec, uint64_t sequence, flightrec_record_t *record)
+{
+    if (rec->header == nullptr || sequence == 0)
+    {
+        return false;
+    }
+
+    const flightrec_record_t *slot = &rec->records[(sequence - 1) % rec->header->capacity];
+    if (__atomic_load_n(&slot->sequence, __ATOMIC_ACQUIRE) != sequence)
+    {
+        return false;
+    }
+    memcpy(record, slot, sizeof(flightrec_record_t));
+    __atomic_thread_fence(__ATOMIC_ACQUIRE);
+
+    return __atomic_load_n(&slot->sequence, __ATOMIC_RELAXED) == sequence;
+}
+
+void flightrec_close(flightrec_t *rec)
+{
+    if (rec->header == nullptr)
+    {
+        return;
+    }
+
+    if (rec->writer)
+    {
+        msync(rec->header, rec->size, MS_SYNC);
+    }
+    munmap(rec->header, rec->size);
+    rec->header = nullptr;
+    close(rec->fd);
+}
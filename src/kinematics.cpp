@@ -0,0 +1,106 @@
+/**
+ * @file kinematics.cpp
+ * @author Mit Bailey (mitbailey99@gmail.com)
+ * @brief
+ * @version See Git tags for version information.
+ * @date 2026.10.18
+ *
+ * @copyright Copyright (c) 2021
+ *
+ */
+
+#include <math.h>
+#include "meb_debug.h"
+#include "kinematics.hpp"
+
+double axis_move_time(const axis_model_t *model, double distance)
+{
+    distance = fabs(distance);
+
+    // Distance needed to reach full rate and stop again.
+    double ramp = model->max_rate * model->max_rate / model->accel;
+    if (distance < ramp)
+    {
+        return 2.0 * sqrt(distance / model->accel);
+    }
+    return distance / model->max_rate + model->max_rate / model->accel;
+}
+
+void axis_simulate(const axis_model_t *model, double target, double step, axis_state_t *state)
+{
+    double distance = target - state->motor;
+    double wanted = copysign(fmin(model->max_rate, sqrt(2.0 * model->accel * fabs(distance))), distance);
+    double dv = model->accel * step;
+    state->rate = fmax(fmin(wanted, state->rate + dv), state->rate - dv);
+    state->motor += state->rate * step;
+
+    double half = model->backlash / 2.0;
+    if (state->motor - state->output > half)
+    {
+        state->output = state->motor - half;
+    }
+    else if (state->motor - state->output < -half)
+    {
+        state->output = state->motor + half;
+    }
+}
+
+int axis_plan_commands(const axis_model_t *model, const float *path, size_t n, double step, double start, float *commands, axis_plan_report_t *report)
+{
+    if (model == nullptr || path == nullptr || commands == nullptr || n < 1 || step <= 0)
+    {
+        dbprintlf(RED_FG "Invalid trajectory arguments.");
+        return -1;
+    }
+
+    double q = model->quantum;
+    double level = round(start / q) * q;
+    double last_switch = -model->min_interval;
+    int direction = 0;
+
+    axis_state_t axis = {start, 0, start};
+    int num_commands = 0, infeasible = 0;
+    double error_sum = 0, max_error = 0;
+
+    for (size_t i = 0; i < n; i++)
+    {
+        double t = i * step;
+
+        if (i > 0 && fabs(path[i] - path[i - 1]) > model->max_rate * step)
+        {
+            infeasible++;
+        }
+
+        double want = round(path[i] / q) * q;
+        if (want != level && t - last_switch >= model->min_interval - 1e-9)
+        {
+            // Reversals first take up the backlash, so lead by it in the new direction.
+            int new_direction = want > level ? 1 : -1;
+            if (direction != 0 && new_direction != direction)
+            {
+                want = round((path[i] + new_direction * model->backlash) / q) * q;
+            }
+            direction = new_direction;
+            level = want;
+            last_switch = t;
+            num_commands++;
+        }
+        commands[i] = level;
+
+        axis_simulate(model, level, step, &axis);
+        // Pointing error, an axis a whole turn away points the same way.
+        double error = fabs(remainder(path[i] - axis.output, 360.0));
+        error_sum += error;
+        max_error = fmax(max_error, error);
+    }
+
+    if (report != nullptr)
+    {
+        report->commands = num_commands;
+        report->infeasible = infeasible;
+        report->mean_error = error_sum / n;
+        report->max_error = max_error;
+    }
+
+    return num_commands;
+}
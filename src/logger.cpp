@@ -0,0 +1,291 @@
+/**
+ * @file logger.cpp
+ * @author Mit Bailey (mitbailey99@gmail.com)
+ * @brief
+ * @version See Git tags for version information.
+ * @date 2026.10.18
+ *
+ * @copyright Copyright (c) 2021
+ *
+ */
+
+#include <errno.h>
+#include <inttypes.h>
+#include <pthread.h>
+#include <stdlib.h>
+#include <sys/eventfd.h>
+#include <unistd.h>
+#include <atomic>
+#include "logger.hpp"
+
+#define LOG_LINE_MAX 1024 // bytes of one formatted record
+#define LOG_OUT_SIZE 0x4000 // bytes written per fwrite
+
+typedef enum
+{
+    LOG_RING_FREE,
+    LOG_RING_OWNED,
+    LOG_RING_RELEASED // Its thread exited, free again once drained.
+} log_ring_state_t;
+
+// Single producer (the owning thread), single consumer (the writer thread).
+typedef struct
+{
+    std::atomic<int> state;
+    alignas(64) std::atomic<uint32_t> head; // Next slot to fill, written by the producer.
+    alignas(64) std::atomic<uint32_t> tail; // Next slot to write out, written by the consumer.
+    std::atomic<uint64_t> dropped;
+    uint64_t dropped_reported; // Consumer only.
+    log_record_t slots[LOG_RING_SLOTS];
+} log_ring_t;
+
+static log_ring_t rings[LOG_MAX_THREADS];
+static pthread_once_t logger_once = PTHREAD_ONCE_INIT;
+static pthread_t logger_tid;
+static std::atomic<bool> logger_running(false);
+static int logger_event = -1; // Wakes the writer, which blocks on it while every ring is empty.
+
+static void logger_wake()
+{
+    uint64_t one = 1;
+    if (write(logger_event, &one, sizeof(one)) < 0)
+    {
+        return; // Only fails once the counter would overflow, the writer is awake then.
+    }
+}
+
+// Hands the ring back when its thread exits, so threads restarted on reconnect do not use up the rings.
+struct log_thread_t
+{
+    log_ring_t *ring = nullptr;
+    bool claimed = false;
+
+    ~log_thread_t()
+    {
+        if (ring != nullptr)
+        {
+            ring->state.store(LOG_RING_RELEASED, std::memory_order_release);
+            logger_wake(); // An empty ring is only freed by the writer.
+        }
+    }
+};
+
+static thread_local log_thread_t log_thread;
+
+static int logger_format(const log_record_t *record, char *out, int size)
+{
+    int len = snprintf(out, size, "[%s:%d | %s] ", record->file, record->line, record->func);
+    len = len < size ? len : size - 1;
+
+    int body;
+    if (record->truncated)
+    {
+        body = snprintf(out + len, size - len, "%s (arguments truncated)", record->format);
+    }
+    else
+    {
+        body = record->formatter(out + len, size - len, record->format, record->args);
+    }
+    len += body < 0 ? 0 : body;
+    len = len < size ? len : size - 1;
+
+    int end = snprintf(out + len, size - len, "\x1b[0m%s", record->newline ? "\n" : "");
+    len += end;
+    return len < size ? len : size - 1;
+}
+
+/**
+ * @brief Writes out every queued record, oldest first across all rings.
+ *
+ * @return int Records written.
+ */
+static int logger_drain()
+{
+    static char out[LOG_OUT_SIZE];
+    int used = 0;
+    int written = 0;
+
+    for (;;)
+    {
+        // Pairs with the fence in logger_commit(): either this scan sees a new head or the producer sees the
+        // ring was empty and wakes the writer.
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+
+        log_ring_t *oldest = nullptr;
+        for (int i = 0; i < LOG_MAX_THREADS; i++)
+        {
+            log_ring_t *ring = &rings[i];
+            uint32_t tail = ring->tail.load(std::memory_order_relaxed);
+            if (tail == ring->head.load(std::memory_order_acquire))
+            {
+                continue;
+            }
+            if (oldest == nullptr || ring->slots[tail % LOG_RING_SLOTS].time < oldest->slots[oldest->tail.load(std::memory_order_relaxed) % LOG_RING_SLOTS].time)
+            {
+                oldest = ring;
+            }
+        }
+        if (oldest == nullptr)
+        {
+            break;
+        }
+
+        if (LOG_OUT_SIZE - used < LOG_LINE_MAX)
+        {
+            fwrite(out, 1, used, stderr);
+            used = 0;
+        }
+
+        uint32_t tail = oldest->tail.load(std::memory_order_relaxed);
+        used += logger_format(&oldest->slots[tail % LOG_RING_SLOTS], out + used, LOG_LINE_MAX);
+        oldest->tail.store(tail + 1, std::memory_order_release);
+        written++;
+    }
+
+    for (int i = 0; i < LOG_MAX_THREADS; i++)
+    {
+        log_ring_t *ring = &rings[i];
+        uint64_t dropped = ring->dropped.load(std::memory_order_relaxed);
+        if (dropped != ring->dropped_reported && LOG_OUT_SIZE - used >= LOG_LINE_MAX)
+        {
+            used += snprintf(out + used, LOG_LINE_MAX, "[logger] \x1b[91m%" PRIu64 " records dropped, log ring %d full\x1b[0m\n", dropped - ring->dropped_reported, i);
+            ring->dropped_reported = dropped;
+        }
+
+        int released = LOG_RING_RELEASED;
+        if (ring->tail.load(std::memory_order_relaxed) == ring->head.load(std::memory_order_acquire))
+        {
+            ring->state.compare_exchange_strong(released, LOG_RING_FREE, std::memory_order_acq_rel);
+        }
+    }
+
+    if (used > 0)
+    {
+        fwrite(out, 1, used, stderr);
+        fflush(stderr);
+    }
+    return written;
+}
+
+static void *logger_thread(void *args)
+{
+    while (logger_running.load(std::memory_order_acquire))
+    {
+        if (logger_drain() == 0)
+        {
+            uint64_t count;
+            if (read(logger_event, &count, sizeof(count)) < 0 && errno != EINTR)
+            {
+                break;
+            }
+        }
+    }
+    logger_drain();
+
+    return NULL;
+}
+
+static void logger_stop()
+{
+    if (logger_running.exchange(false))
+    {
+        logger_wake();
+        pthread_join(logger_tid, NULL);
+    }
+}
+
+static void logger_start()
+{
+    logger_event = eventfd(0, EFD_CLOEXEC);
+    if (logger_event < 0)
+    {
+        return;
+    }
+
+    logger_running.store(true, std::memory_order_release);
+    if (pthread_create(&logger_tid, NULL, logger_thread, NULL) != 0)
+    {
+        logger_running.store(false);
+        close(logger_event);
+        logger_event = -1;
+        return;
+    }
+    atexit(logger_stop);
+}
+
+log_record_t *logger_reserve(log_record_t *fallback)
+{
+    pthread_once(&logger_once, logger_start);
+
+    if (!log_thread.claimed)
+    {
+        log_thread.claimed = true;
+        for (int i = 0; i < LOG_MAX_THREADS; i++)
+        {
+            int free_state = LOG_RING_FREE;
+            if (rings[i].state.compare_exchange_strong(free_state, LOG_RING_OWNED, std::memory_order_acq_rel))
+            {
+                log_thread.ring = &rings[i];
+                break;
+            }
+        }
+    }
+
+    log_ring_t *ring = log_thread.ring;
+    if (ring == nullptr || !logger_running.load(std::memory_order_acquire))
+    {
+        return fallback;
+    }
+
+    uint32_t head = ring->head.load(std::memory_order_relaxed);
+    if (head - ring->tail.load(std::memory_order_acquire) >= LOG_RING_SLOTS)
+    {
+        ring->dropped.fetch_add(1, std::memory_order_relaxed);
+        return nullptr;
+    }
+    return &ring->slots[head % LOG_RING_SLOTS];
+}
+
+void logger_commit(log_record_t *record)
+{
+    log_ring_t *ring = log_thread.ring;
+    if (ring != nullptr)
+    {
+        uint32_t head = ring->head.load(std::memory_order_relaxed);
+        if (record == &ring->slots[head % LOG_RING_SLOTS])
+        {
+            ring->head.store(head + 1, std::memory_order_release);
+
+            // Only the record that made the ring non-empty wakes the writer, it drains the rest in the same pass.
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+            if (ring->tail.load(std::memory_order_relaxed) == head)
+            {
+                logger_wake();
+            }
+            return;
+        }
+    }
+
+    char line[LOG_LINE_MAX];
+    int len = logger_format(record, line, sizeof(line));
+    fwrite(line, 1, len, stderr);
+    fflush(stderr);
+}
+
+void logger_flush()
+{
+    struct timespec wait = {0, LOG_FLUSH_NS};
+
+    for (bool pending = true; pending && logger_running.load(std::memory_order_acquire);)
+    {
+        pending = false;
+        for (int i = 0; i < LOG_MAX_THREADS; i++)
+        {
+            pending |= rings[i].tail.load(std::memory_order_acquire) != rings[i].head.load(std::memory_order_acquire);
+        }
+        if (pending)
+        {
+            nanosleep(&wait, NULL);
+        }
+    }
+}
@@ -12,16 +12,26 @@
  */
 
 #include <unistd.h>
+#include <stdlib.h>
 #include <string.h>
 #include "CoordGeodetic.h"
 #include "CoordTopocentric.h"
 #include "Observer.h"
 #include "SGP4.h"
 #include "meb_debug.h"
+#include "simclock.hpp"
+#include "simrotator.hpp"
 #include "track.hpp"
 #include "network.hpp"
 #include <signal.h>
 
+static global_data_t *signal_global = NULL;
+
+static void on_signal(int sig)
+{
+    signal_global->done = 1;
+}
+
 int main(int argc, char *argv[])
 {
     signal(SIGPIPE, SIG_IGN);
@@ -30,54 +40,148 @@ int main(int argc, char *argv[])
     global->network_data->recv_active = true;    
 
     strcpy(global->devname, "/dev/ttyUSB0");
+    global->track_rate_hz = TRACK_RATE_HZ;
+    global->telem_rate_hz = TELEM_RATE_HZ;
+
+    double sim_speed = 0;
+    bool sim_network = false;
+    const char *sim_start = NULL;
+
+    int opt;
+    while ((opt = getopt(argc, argv, "fNc:r:s:t:T:R:")) != -1)
+    {
+        switch (opt)
+        {
+        case 'r':
+            global->track_rate_hz = atoi(optarg);
+            if (global->track_rate_hz < 1 || global->track_rate_hz > TRACK_RATE_MAX)
+            {
+                dbprintlf(FATAL "Tracking rate must be 1 to %d Hz.", TRACK_RATE_MAX);
+                return -1;
+            }
+            break;
+        case 'T':
+            global->telem_rate_hz = atoi(optarg);
+            if (global->telem_rate_hz < 0 || global->telem_rate_hz > TELEM_RATE_MAX)
+            {
+                dbprintlf(FATAL "Telemetry rate must be 0 (off) to %d Hz.", TELEM_RATE_MAX);
+                return -1;
+            }
+            break;
+        case 'f':
+            global->rotator_feedback = true;
+            break;
+        case 'N':
+            sim_network = true;
+            break;
+        case 'c':
+            global->catalog_path = optarg;
+            break;
+        case 'R':
+            global->flightrec_path = optarg; // Off unless given, the file takes 64 MiB.
+            break;
+        case 's':
+            sim_speed = atof(optarg);
+            if (sim_speed < 1 || sim_speed > SIMCLOCK_MAX_SCALE)
+            {
+                dbprintlf(FATAL "Simulation speed must be 1 to %.0f.", SIMCLOCK_MAX_SCALE);
+                return -1;
+            }
+            break;
+        case 't':
+            sim_start = optarg;
+            break;
+        default:
+            dbprintlf(FATAL "Usage: %s [-f] [-c catalog_file] [-r rate_hz] [-T telem_hz] [-R flightrec_file] [-s sim_speed [-t unix_start] [-N]] [devname]", argv[0]);
+            return -1;
+        }
+    }
 
-    if (argc > 2)
+    if (argc - optind > 1)
     {
         dbprintlf(FATAL "Invalid number of command-line arguments given.");
         return -1;
     }
-    else if (argc == 2)
+    else if (argc - optind == 1)
     {
-        strcpy(global->devname, argv[1]);
+        strcpy(global->devname, argv[optind]);
     }
     global->resetAtInit = false;
-    if (argc > 1)
+    if (argc - optind > 0)
         global->resetAtInit = true;
-    pthread_t net_polling_tid, net_rx_tid, tracking_tid, track_status_tid;
 
-    while (global->network_data->thread_status > -1)
+    // Simulation: the tracker drives a virtual rotator through its normal serial path, on accelerated time.
+    sim_rotator_t sim[1];
+    if (sim_speed > 0)
+    {
+        DateTime start = DateTime::Now(true);
+        if (sim_start != NULL)
+        {
+            start = DateTime(UnixEpoch + (int64_t)atoll(sim_start) * TicksPerSecond);
+        }
+        if (simclock_init(sim_speed, start) < 0 || sim_rotator_start(sim, -AZIM_ADJ, 90) < 0)
+        {
+            dbprintlf(FATAL "Could not start the simulation.");
+            return -1;
+        }
+        strcpy(global->devname, sim->devname);
+        global->resetAtInit = false;
+        global->sim = sim;
+        global->rotator_feedback = true; // The virtual rotator answers position queries.
+    }
+
+    // The first signal shuts down cleanly (shared memory, sockets and the flight recorder are released), a second
+    // one kills the process.
+    signal_global = global;
+    struct sigaction action;
+    memset(&action, 0, sizeof(action));
+    action.sa_handler = on_signal;
+    action.sa_flags = SA_RESETHAND;
+    sigaction(SIGINT, &action, NULL);
+    sigaction(SIGTERM, &action, NULL);
+
+    pthread_t net_polling_tid, track_event_tid;
+
+    // Tracking runs for the whole process, the server link is restarted underneath it.
+    global->network_data->thread_status = 1;
+    pthread_create(&track_event_tid, NULL, track_event_thread, global);
+
+    // A simulation stays off the server unless asked for, e.g. to run against tools/gs_standin.out.
+    if (global->sim != NULL && !sim_network)
+    {
+        dbprintlf(YELLOW_FG "Simulation without a server connection, -N to connect.");
+        while (!global->done)
+        {
+            usleep(100000);
+        }
+    }
+
+    while (global->network_data->thread_status > -1 && !global->done)
     {
         global->network_data->thread_status = 1;
 
+        // Connection upkeep stays with the network library, everything else runs on the event loop.
         pthread_create(&net_polling_tid, NULL, gs_polling_thread, global->network_data);
-        pthread_create(&net_rx_tid, NULL, gs_network_rx_thread, global);
-        pthread_create(&tracking_tid, NULL, tracking_thread, global);
-        pthread_create(&track_status_tid, NULL, track_status_thread, global);
 
         void *thread_return;
         pthread_join(net_polling_tid, &thread_return);
-        pthread_join(net_rx_tid, &thread_return);
-        pthread_join(tracking_tid, &thread_return);
-        pthread_join(track_status_tid, &thread_return);
 
         usleep(1 SEC);
     }
 
     // Finished.
-    void *thread_return;
-    pthread_cancel(net_polling_tid);
-    pthread_cancel(net_rx_tid);
-    pthread_cancel(tracking_tid);
-    pthread_cancel(track_status_tid);
-    thread_return == PTHREAD_CANCELED ? printf("Good net_polling_tid join.\n") : printf("Bad net_polling_tid join.\n");
-    pthread_join(net_rx_tid, &thread_return);
-    thread_return == PTHREAD_CANCELED ? printf("Good net_rx_tid join.\n") : printf("Bad net_rx_tid join.\n");
-    pthread_join(tracking_tid, &thread_return);
-    thread_return == PTHREAD_CANCELED ? printf("Good tracking_tid join.\n") : printf("Bad tracking_tid join.\n");
-    pthread_join(track_status_tid, &thread_return);
-    thread_return == PTHREAD_CANCELED ? printf("Good track_status_tid join.\n") : printf("Bad track_status_tid join.\n");
-
-    close(global->network_data->socket);
+    global->done = 1;
+    pthread_join(track_event_tid, NULL);
+
+    if (global->network_data->socket > 2)
+    {
+        close(global->network_data->socket);
+    }
+
+    if (global->sim != NULL)
+    {
+        sim_rotator_stop(global->sim);
+    }
 
     int retval = global->network_data->thread_status;
     delete global->network_data;
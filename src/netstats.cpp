@@ -0,0 +1,260 @@
+/**
+ * @file netstats.cpp
+ * @author Mit Bailey (mitbailey99@gmail.com)
+ * @brief
+ * @version See Git tags for version information.
+ * @date 2026.10.18
+ *
+ * @copyright Copyright (c) 2021
+ *
+ */
+
+#include <errno.h>
+#include <inttypes.h>
+#include <math.h>
+#include <stdio.h>
+#include <string.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+#include "meb_debug.h"
+#include "netstats.hpp"
+#include "network.hpp"
+
+static const NetType netstats_types[NETSTATS_TYPES - 1] = {NetType::POLL, NetType::ACK, NetType::NACK, NetType::CONFIG, NetType::DATA, NetType::TRACKING_COMMAND, NetType::TRACKING_DATA};
+static const char *netstats_names[NETSTATS_TYPES] = {"POLL", "ACK", "NACK", "CONFIG", "DATA", "TRACKING_COMMAND", "TRACKING_DATA", "OTHER"};
+
+static double elapsed(const struct timespec *from, const struct timespec *to)
+{
+    return (to->tv_sec - from->tv_sec) + (to->tv_nsec - from->tv_nsec) / 1e9;
+}
+
+/**
+ * @brief Drops every frame still awaiting an ACK from RTT matching.
+ *
+ */
+static void netstats_resync(netstats_t *stats)
+{
+    stats->discarded += stats->inflight_count;
+    stats->inflight_head = 0;
+    stats->inflight_count = 0;
+}
+
+static uint64_t total(const netstats_count_t *counts, bool bytes)
+{
+    uint64_t sum = 0;
+    for (int i = 0; i < NETSTATS_TYPES; i++)
+    {
+        sum += bytes ? counts[i].bytes : counts[i].frames;
+    }
+    return sum;
+}
+
+void netstats_init(netstats_t *stats)
+{
+    memset(stats, 0, sizeof(netstats_t));
+    clock_gettime(CLOCK_MONOTONIC, &stats->start);
+}
+
+int netstats_type_index(int type)
+{
+    for (int i = 0; i < NETSTATS_TYPES - 1; i++)
+    {
+        if ((int)netstats_types[i] == type)
+        {
+            return i;
+        }
+    }
+    return NETSTATS_TYPES - 1;
+}
+
+uint32_t netstats_sent(netstats_t *stats, int type, long bytes, bool expects_ack)
+{
+    int index = netstats_type_index(type);
+    uint32_t sequence = stats->sequence++;
+
+    if (bytes < 0)
+    {
+        stats->failed[index].frames++;
+        return sequence;
+    }
+    stats->sent[index].frames++;
+    stats->sent[index].bytes += bytes;
+
+    if (expects_ack)
+    {
+        // A full window means the oldest has waited long enough to be lost.
+        if (stats->inflight_count == NETSTATS_INFLIGHT)
+        {
+            stats->inflight_head = (stats->inflight_head + 1) % NETSTATS_INFLIGHT;
+            stats->inflight_count--;
+            stats->unacked++;
+        }
+        netstats_inflight_t *slot = &stats->inflight[(stats->inflight_head + stats->inflight_count) % NETSTATS_INFLIGHT];
+        slot->sequence = sequence;
+        clock_gettime(CLOCK_MONOTONIC, &slot->sent);
+        stats->inflight_count++;
+    }
+    return sequence;
+}
+
+void netstats_received(netstats_t *stats, int type, long bytes, const struct timespec *now)
+{
+    int index = netstats_type_index(type);
+    stats->received[index].frames++;
+    stats->received[index].bytes += bytes > 0 ? bytes : 0;
+
+    if ((type != (int)NetType::ACK && type != (int)NetType::NACK) || stats->inflight_count == 0)
+    {
+        return;
+    }
+
+    if (type == (int)NetType::NACK)
+    {
+        stats->nacked++;
+        stats->inflight_head = (stats->inflight_head + 1) % NETSTATS_INFLIGHT;
+        stats->inflight_count--;
+        netstats_resync(stats);
+        return;
+    }
+
+    double rtt = elapsed(&stats->inflight[stats->inflight_head].sent, now);
+    stats->inflight_head = (stats->inflight_head + 1) % NETSTATS_INFLIGHT;
+    stats->inflight_count--;
+
+    int bin = 0;
+    while (bin < NETSTATS_RTT_BINS - 1 && rtt * 1e3 >= (1 << bin))
+    {
+        bin++;
+    }
+    stats->rtt_bins[bin]++;
+    stats->rtt_count++;
+    stats->rtt_sum += rtt;
+    stats->rtt_max = fmax(stats->rtt_max, rtt);
+}
+
+int netstats_expire(netstats_t *stats, const struct timespec *now)
+{
+    int expired = 0;
+    while (stats->inflight_count > 0 && elapsed(&stats->inflight[stats->inflight_head].sent, now) > NETSTATS_ACK_TIMEOUT)
+    {
+        stats->inflight_head = (stats->inflight_head + 1) % NETSTATS_INFLIGHT;
+        stats->inflight_count--;
+        stats->unacked++;
+        expired++;
+    }
+    if (expired > 0)
+    {
+        netstats_resync(stats);
+    }
+    return expired;
+}
+
+void netstats_report(const netstats_t *stats, netstats_report_t *report)
+{
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+
+    report->magic = NETSTATS_MAGIC;
+    report->version = NETSTATS_VERSION;
+    report->reserved = 0;
+    report->sequence = stats->sequence;
+    report->uptime = elapsed(&stats->start, &now);
+    report->sent_frames = total(stats->sent, false);
+    report->sent_bytes = total(stats->sent, true);
+    report->received_frames = total(stats->received, false);
+    report->received_bytes = total(stats->received, true);
+    report->failed = total(stats->failed, false);
+    report->unacked = stats->unacked;
+    report->rtt_mean = stats->rtt_count ? stats->rtt_sum / stats->rtt_count * 1e3 : 0;
+    report->rtt_max = stats->rtt_max * 1e3;
+    for (int i = 0; i < NETSTATS_RTT_BINS; i++)
+    {
+        report->rtt_bins[i] = stats->rtt_bins[i];
+    }
+}
+
+int netstats_format(const netstats_t *stats, char *buffer, int size)
+{
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    double uptime = elapsed(&stats->start, &now);
+
+    int len = snprintf(buffer, size, "uptime %.0f s, %u frames sent, %d awaiting ACK, %" PRIu64 " unacknowledged, %" PRIu64 " NACKed\n", uptime, stats->sequence, stats->inflight_count, stats->unacked, stats->nacked);
+    len += snprintf(buffer + len, size > len ? size - len : 0, "%-16s %10s %12s %10s %12s %8s %10s\n", "type", "sent", "bytes", "received", "bytes", "failed", "sent/s");
+    for (int i = 0; i < NETSTATS_TYPES; i++)
+    {
+        if (stats->sent[i].frames == 0 && stats->received[i].frames == 0 && stats->failed[i].frames == 0)
+        {
+            continue;
+        }
+        len += snprintf(buffer + len, size > len ? size - len : 0, "%-16s %10" PRIu64 " %12" PRIu64 " %10" PRIu64 " %12" PRIu64 " %8" PRIu64 " %10.2f\n", netstats_names[i], stats->sent[i].frames, stats->sent[i].bytes, stats->received[i].frames, stats->received[i].bytes, stats->failed[i].frames, uptime > 0 ? stats->sent[i].frames / uptime : 0);
+    }
+
+    if (stats->rtt_count > 0)
+    {
+        len += snprintf(buffer + len, size > len ? size - len : 0, "ACK round trip: %.2f ms mean, %.2f ms max over %" PRIu64 "\n", stats->rtt_sum / stats->rtt_count * 1e3, stats->rtt_max * 1e3, stats->rtt_count);
+        len += snprintf(buffer + len, size > len ? size - len : 0, "  ACKs carry no sequence id and are matched in order; %" PRIu64 " frames dropped from matching after a NACK or timeout\n", stats->discarded);
+        for (int i = 0; i < NETSTATS_RTT_BINS; i++)
+        {
+            if (stats->rtt_bins[i] == 0)
+            {
+                continue;
+            }
+            if (i == NETSTATS_RTT_BINS - 1)
+            {
+                len += snprintf(buffer + len, size > len ? size - len : 0, "  >= %5d ms %10" PRIu64 "\n", 1 << (i - 1), stats->rtt_bins[i]);
+            }
+            else
+            {
+                len += snprintf(buffer + len, size > len ? size - len : 0, "  <  %5d ms %10" PRIu64 "\n", 1 << i, stats->rtt_bins[i]);
+            }
+        }
+    }
+
+    return len < size ? len : size - 1;
+}
+
+int netstats_listen(const char *path)
+{
+    struct sockaddr_un addr;
+    memset(&addr, 0, sizeof(addr));
+    addr.sun_family = AF_UNIX;
+    if (strlen(path) >= sizeof(addr.sun_path))
+    {
+        dbprintlf(RED_FG "Stats socket path too long: %s", path);
+        return -1;
+    }
+    strcpy(addr.sun_path, path);
+
+    int fd = socket(AF_UNIX, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+    if (fd < 0)
+    {
+        dbprintlf(RED_FG "Could not create stats socket, error %d.", errno);
+        return -1;
+    }
+
+    unlink(path);
+    if (bind(fd, (struct sockaddr *)&addr, sizeof(addr)) < 0 || listen(fd, 4) < 0)
+    {
+        dbprintlf(RED_FG "Could not listen on %s, error %d.", path, errno);
+        close(fd);
+        return -1;
+    }
+    return fd;
+}
+
+void netstats_serve(const netstats_t *stats, int listener)
+{
+    int client;
+    while ((client = accept4(listener, NULL, NULL, SOCK_NONBLOCK | SOCK_CLOEXEC)) >= 0)
+    {
+        char report[2048];
+        int len = netstats_format(stats, report, sizeof(report));
+        if (write(client, report, len) != len)
+        {
+            dbprintlf(RED_FG "Stats query answered partially.");
+        }
+        close(client);
+    }
+}
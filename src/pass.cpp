@@ -0,0 +1,366 @@
+/**
+ * @file pass.cpp
+ * @author Mit Bailey (mitbailey99@gmail.com)
+ * @brief
+ * @version See Git tags for version information.
+ * @date 2026.10.18
+ *
+ * @copyright Copyright (c) 2021
+ *
+ */
+
+#include <math.h>
+#include <time.h>
+#include "CoordTopocentric.h"
+#include "Util.h"
+#include "meb_debug.h"
+#include "pass.hpp"
+
+int pass_build(pass_t *pass, const SGP4 *model, uint32_t generation, Observer *dish, const DateTime &start, double min_elev)
+{
+    if (pass == nullptr || model == nullptr || dish == nullptr)
+    {
+        dbprintlf(RED_FG "Invalid pass table arguments.");
+        return -1;
+    }
+
+    struct timespec tstart, tend;
+    clock_gettime(CLOCK_MONOTONIC, &tstart);
+
+    pass_clear(pass);
+    pass->step = 1.0 / PASS_TABLE_RATE;
+    pass->start = start;
+    pass->samples.reserve(PASS_MAX_DURATION * PASS_TABLE_RATE + 1);
+
+    bool risen = false;
+    for (int i = 0; i <= PASS_MAX_DURATION * PASS_TABLE_RATE; i++)
+    {
+        Eci eci;
+        if (model->FindPosition(start.AddSeconds(i * pass->step), eci) != SGP4::OK)
+        {
+            break;
+        }
+        CoordTopocentric look = dish->GetLookAngle(eci);
+
+        pass_sample_t sample;
+        sample.az = Util::RadiansToDegrees(look.azimuth);
+        sample.az_wrap = sample.az;
+        sample.el = Util::RadiansToDegrees(look.elevation);
+        sample.el_axis = sample.el;
+        sample.range_rate = look.range_rate;
+        sample.az_cmd = sample.az_wrap;
+        sample.el_cmd = sample.el_axis;
+        pass->samples.push_back(sample);
+
+        if (sample.el >= min_elev)
+        {
+            risen = true;
+        }
+        else if (risen)
+        {
+            // One sample below the mask so the set can be interpolated.
+            break;
+        }
+    }
+
+    if (pass->samples.size() < 2)
+    {
+        pass_clear(pass);
+        return -1;
+    }
+    pass->model = model;
+    pass->generation = generation;
+    pass->unwinds = 0;
+    pass->flipped = false;
+    pass->scheduled = false;
+
+    // Peak azimuth rate, seen near culmination of high passes.
+    pass->peak_az_rate = 0;
+    for (size_t i = 1; i < pass->samples.size(); i++)
+    {
+        double rate = fabs(Util::WrapNegPos180(pass->samples[i].az - pass->samples[i - 1].az)) / pass->step;
+        pass->peak_az_rate = fmax(pass->peak_az_rate, rate);
+    }
+
+    clock_gettime(CLOCK_MONOTONIC, &tend);
+    double elapsed = (tend.tv_sec - tstart.tv_sec) * 1e3 + (tend.tv_nsec - tstart.tv_nsec) / 1e6;
+    dbprintlf(BLUE_FG "Built pass table: %zu samples over %.1f s (%.1f ms).", pass->samples.size(), (pass->samples.size() - 1) * pass->step, elapsed);
+
+    return pass->samples.size();
+}
+
+/**
+ * @brief Walks the unwrapped az_wrap path starting on the wrap offset by `offset` degrees, turning back a full circle
+ * whenever it would leave the range.
+ *
+ * @param pass
+ * @param offset Added to the unwrapped path, multiple of 360 degrees.
+ * @param az_min
+ * @param az_max
+ * @param write Store the result in az_wrap.
+ * @return int Number of unwinds.
+ */
+static int pass_walk_wrap(pass_t *pass, double offset, double az_min, double az_max, bool write)
+{
+    int unwinds = 0;
+    double u = pass->samples[0].az_wrap;
+    double prev = u;
+    for (size_t i = 0; i < pass->samples.size(); i++)
+    {
+        // Whole turns written by this walk drop out of the difference.
+        if (i > 0)
+        {
+            double az = pass->samples[i].az_wrap;
+            u += Util::WrapNegPos180(az - prev);
+            prev = az;
+        }
+
+        double c = u + offset;
+        if (c < az_min)
+        {
+            offset += 360.0;
+            unwinds++;
+        }
+        else if (c > az_max)
+        {
+            offset -= 360.0;
+            unwinds++;
+        }
+
+        if (write)
+        {
+            pass->samples[i].az_wrap = u + offset;
+        }
+    }
+    return unwinds;
+}
+
+/**
+ * @brief Finds the starting wrap with the least slew from current plus 360 degrees per unwind.
+ *
+ * @return double The cost, degrees.
+ */
+static double pass_best_wrap(pass_t *pass, double current, double az_min, double az_max, double *best_offset, int *best_unwinds)
+{
+    // Every wrap the first sample can start on.
+    double az0 = pass->samples[0].az_wrap;
+    double best_cost = -1;
+    for (double offset = ceil((az_min - az0) / 360.0) * 360.0; az0 + offset <= az_max; offset += 360.0)
+    {
+        int unwinds = pass_walk_wrap(pass, offset, az_min, az_max, false);
+        double cost = fabs(az0 + offset - current) + 360.0 * unwinds;
+        if (best_cost < 0 || cost < best_cost || (cost == best_cost && unwinds < *best_unwinds))
+        {
+            best_cost = cost;
+            *best_offset = offset;
+            *best_unwinds = unwinds;
+        }
+    }
+    return best_cost;
+}
+
+int pass_plan_wrap(pass_t *pass, double current, double az_min, double az_max)
+{
+    if (pass->samples.size() < 2 || az_max - az_min < 360.0)
+    {
+        dbprintlf(RED_FG "Cannot plan the cable wrap.");
+        return -1;
+    }
+
+    double offset = 0;
+    int unwinds = 0;
+    pass_best_wrap(pass, current, az_min, az_max, &offset, &unwinds);
+    pass_walk_wrap(pass, offset, az_min, az_max, true);
+    pass->unwinds = unwinds;
+
+    dbprintlf(BLUE_FG "Planned cable wrap: start %.1f AZ, %d unwind(s) during the pass.", pass->samples[0].az_wrap, unwinds);
+
+    return unwinds;
+}
+
+/**
+ * @brief Resets the axis angles to the direct (az, el) or flipped (az + 180, 180 - el) form of every sample.
+ *
+ */
+static void pass_set_axes(pass_t *pass, bool flip)
+{
+    for (size_t i = 0; i < pass->samples.size(); i++)
+    {
+        pass_sample_t *sample = &pass->samples[i];
+        sample->az_wrap = flip ? fmod(sample->az + 180.0, 360.0) : sample->az;
+        sample->el_axis = flip ? 180.0 - sample->el : sample->el;
+    }
+    pass->flipped = flip;
+}
+
+/**
+ * @brief Replaces the azimuth path by one the axis can follow: the average of the path rate-limited forwards
+ * (lagging) and backwards (leading), so the axis starts swinging before culmination and the lag is split evenly
+ * either side of it.
+ *
+ */
+static void pass_swing(pass_t *pass, double max_rate)
+{
+    size_t n = pass->samples.size();
+    double limit = max_rate * pass->step;
+
+    std::vector<double> path(n), lag(n);
+    path[0] = pass->samples[0].az_wrap;
+    for (size_t i = 1; i < n; i++)
+    {
+        path[i] = path[i - 1] + Util::WrapNegPos180(pass->samples[i].az_wrap - pass->samples[i - 1].az_wrap);
+    }
+
+    lag[0] = path[0];
+    for (size_t i = 1; i < n; i++)
+    {
+        lag[i] = fmin(fmax(path[i], lag[i - 1] - limit), lag[i - 1] + limit);
+    }
+
+    double lead = path[n - 1];
+    for (size_t i = n; i-- > 0;)
+    {
+        if (i < n - 1)
+        {
+            lead = fmin(fmax(path[i], lead - limit), lead + limit);
+        }
+        pass->samples[i].az_wrap = (lag[i] + lead) / 2.0;
+    }
+}
+
+int pass_plan_pointing(pass_t *pass, double current, double az_min, double az_max, double el_max, double max_az_rate)
+{
+    if (pass->samples.size() < 2 || az_max - az_min < 360.0)
+    {
+        dbprintlf(RED_FG "Cannot plan the pass.");
+        return -1;
+    }
+
+    // Flipping moves the whole path half a turn, which can keep a pass off the ends of the azimuth range.
+    float min_el = pass->samples[0].el;
+    for (size_t i = 1; i < pass->samples.size(); i++)
+    {
+        min_el = fmin(min_el, pass->samples[i].el);
+    }
+    bool flip = false;
+    if (180.0 - min_el <= el_max)
+    {
+        double offset = 0;
+        int unwinds = 0;
+        pass_set_axes(pass, true);
+        double flipped_cost = pass_best_wrap(pass, current, az_min, az_max, &offset, &unwinds);
+        pass_set_axes(pass, false);
+        double direct_cost = pass_best_wrap(pass, current, az_min, az_max, &offset, &unwinds);
+        flip = flipped_cost < direct_cost;
+    }
+    pass_set_axes(pass, flip);
+
+    if (pass->peak_az_rate > max_az_rate)
+    {
+        dbprintlf(YELLOW_FG "Keyhole pass: peak %.1f deg/s AZ exceeds %.1f deg/s, swinging ahead of culmination.", pass->peak_az_rate, max_az_rate);
+        pass_swing(pass, max_az_rate);
+    }
+    if (flip)
+    {
+        dbprintlf(BLUE_FG "Flipped pass: elevation past 90 deg.");
+    }
+
+    return pass_plan_wrap(pass, current, az_min, az_max);
+}
+
+int pass_plan_commands(pass_t *pass, const axis_model_t *az, const axis_model_t *el, double az_start, double el_start)
+{
+    size_t n = pass->samples.size();
+    if (n < 2)
+    {
+        return -1;
+    }
+
+    std::vector<float> path(n), commands(n);
+
+    for (size_t i = 0; i < n; i++)
+    {
+        path[i] = pass->samples[i].az_wrap;
+    }
+    if (axis_plan_commands(az, path.data(), n, pass->step, az_start, commands.data(), &pass->az_report) < 0)
+    {
+        return -1;
+    }
+    for (size_t i = 0; i < n; i++)
+    {
+        pass->samples[i].az_cmd = commands[i];
+        path[i] = pass->samples[i].el_axis;
+    }
+    if (axis_plan_commands(el, path.data(), n, pass->step, el_start, commands.data(), &pass->el_report) < 0)
+    {
+        return -1;
+    }
+    for (size_t i = 0; i < n; i++)
+    {
+        pass->samples[i].el_cmd = commands[i];
+    }
+    pass->scheduled = true;
+
+    dbprintlf(BLUE_FG "Scheduled %d AZ, %d EL commands; predicted error %.2f/%.2f deg AZ, %.2f/%.2f deg EL (mean/max).", pass->az_report.commands, pass->el_report.commands, pass->az_report.mean_error, pass->az_report.max_error, pass->el_report.mean_error, pass->el_report.max_error);
+    if (pass->az_report.infeasible || pass->el_report.infeasible)
+    {
+        dbprintlf(YELLOW_FG "Pass exceeds the axis rate for %.1f s AZ, %.1f s EL.", pass->az_report.infeasible * pass->step, pass->el_report.infeasible * pass->step);
+    }
+
+    return 1;
+}
+
+bool pass_is_current(const pass_t *pass, const SGP4 *model, uint32_t generation, const DateTime &t)
+{
+    if (pass->model == nullptr || pass->model != model || pass->generation != generation)
+    {
+        return false;
+    }
+    double offset = (t - pass->start).TotalSeconds();
+    return offset >= 0 && offset <= (pass->samples.size() - 1) * pass->step;
+}
+
+int pass_lookup(const pass_t *pass, const DateTime &t, pass_sample_t *sample)
+{
+    if (pass->samples.size() < 2)
+    {
+        return -1;
+    }
+
+    double offset = (t - pass->start).TotalSeconds() / pass->step;
+    size_t last = pass->samples.size() - 1;
+    if (offset < 0 || offset > last)
+    {
+        return -1;
+    }
+
+    size_t i = offset;
+    if (i == last)
+    {
+        *sample = pass->samples[last];
+        return 1;
+    }
+    double f = offset - i;
+    const pass_sample_t *a = &pass->samples[i];
+    const pass_sample_t *b = &pass->samples[i + 1];
+
+    double az = a->az + f * Util::WrapNegPos180(b->az - a->az);
+    sample->az = az < 0 ? az + 360.0 : (az >= 360.0 ? az - 360.0 : az);
+    // Do not interpolate through an unwind.
+    double dwrap = b->az_wrap - a->az_wrap;
+    sample->az_wrap = fabs(dwrap) > 180.0 ? (f < 0.5 ? a->az_wrap : b->az_wrap) : a->az_wrap + f * dwrap;
+    sample->el = a->el + f * (b->el - a->el);
+    sample->el_axis = a->el_axis + f * (b->el_axis - a->el_axis);
+    sample->az_cmd = a->az_cmd;
+    sample->el_cmd = a->el_cmd;
+    sample->range_rate = a->range_rate + f * (b->range_rate - a->range_rate);
+
+    return 1;
+}
+
+void pass_clear(pass_t *pass)
+{
+    pass->model = nullptr;
+    pass->generation = 0;
+    pass->samples.clear();
+}
@@ -0,0 +1,407 @@
+/**
+ * @file rotator.cpp
+ * @author Mit Bailey (mitbailey99@gmail.com)
+ * @brief
+ * @version See Git tags for version information.
+ * @date 2026.10.18
+ *
+ * @copyright Copyright (c) 2021
+ *
+ */
+
+#include <math.h>
+#include <string.h>
+#include <unistd.h>
+#include <errno.h>
+#include <inttypes.h>
+#include "meb_debug.h"
+#include "rotator.hpp"
+#include "simclock.hpp"
+#include "track.hpp"
+
+#define NSEC_PER_SEC 1000000000LL
+
+static int64_t timespec_diff_ns(const struct timespec *a, const struct timespec *b)
+{
+    return (a->tv_sec - b->tv_sec) * NSEC_PER_SEC + (a->tv_nsec - b->tv_nsec);
+}
+
+static void timespec_add_ns(struct timespec *ts, int64_t ns)
+{
+    ns += ts->tv_nsec;
+    ts->tv_sec += ns / NSEC_PER_SEC;
+    ts->tv_nsec = ns % NSEC_PER_SEC;
+}
+
+double axis_latency_predict(const axis_latency_t *latency, double travel)
+{
+    return latency->write_time + latency->response_time + fabs(travel) / latency->slew_rate;
+}
+
+void axis_latency_record(axis_latency_t *latency, double write_time)
+{
+    latency->write_time += LATENCY_EWMA_ALPHA * (write_time - latency->write_time);
+}
+
+int rotator_init(rotator_t *rot, int connection)
+{
+    if (rot == nullptr || connection < 3)
+    {
+        dbprintlf(RED_FG "Invalid rotator connection.");
+        return -1;
+    }
+
+    rot->connection = connection;
+    rot->time_scale = simclock_scale();
+    rot->pacing = simclock_wall_ns(ROT_CHAR_PACING);
+    pthread_mutex_init(&rot->lock, NULL);
+
+    for (int i = 0; i < ROT_NUM_AXES; i++)
+    {
+        rot->pending[i] = false;
+        rot->commands[i] = 0;
+        rot->coalesced[i] = 0;
+        rot->query_pending[i] = false;
+        rot->priority[i] = false;
+        rot->started[i].tv_sec = rot->started[i].tv_nsec = 0;
+        rot->written[i].tv_sec = rot->written[i].tv_nsec = 0;
+        rot->has_measured[i] = false;
+        rot->reports[i] = 0;
+        rot->last_query[i].tv_sec = rot->last_query[i].tv_nsec = 0;
+        rot->latency[i].write_time = CMD_WRITE_TIME;
+    }
+    rot->latency[ROT_AZ].response_time = AZ_RESPONSE_TIME;
+    rot->latency[ROT_AZ].slew_rate = AZ_SLEW_RATE;
+    rot->latency[ROT_EL].response_time = EL_RESPONSE_TIME;
+    rot->latency[ROT_EL].slew_rate = EL_SLEW_RATE;
+
+    rot->preempts = 0;
+    rot->preempt_latency_max = 0;
+    rot->preempt_latency_sum = 0;
+
+    rot->active = -1;
+    rot->active_query = false;
+    rot->active_priority = false;
+    rot->last_axis = ROT_EL;
+    rot->rx_len = 0;
+    clock_gettime(CLOCK_MONOTONIC, &rot->next_byte);
+
+    return 1;
+}
+
+void rotator_command(rotator_t *rot, rot_axis_t axis, double angle)
+{
+    pthread_mutex_lock(&rot->lock);
+    if (rot->priority[axis])
+    {
+        pthread_mutex_unlock(&rot->lock);
+        return;
+    }
+    if (rot->pending[axis])
+    {
+        rot->coalesced[axis]++;
+    }
+    else
+    {
+        clock_gettime(CLOCK_MONOTONIC, &rot->requested[axis]);
+    }
+    rot->target[axis] = angle;
+    rot->pending[axis] = true;
+    pthread_mutex_unlock(&rot->lock);
+}
+
+void rotator_preempt(rotator_t *rot, rot_axis_t axis, double angle, const struct timespec *received)
+{
+    pthread_mutex_lock(&rot->lock);
+    if (rot->pending[axis] && !rot->priority[axis])
+    {
+        rot->coalesced[axis]++;
+    }
+    rot->requested[axis] = *received;
+    rot->target[axis] = angle;
+    rot->pending[axis] = true;
+    rot->priority[axis] = true;
+    pthread_mutex_unlock(&rot->lock);
+}
+
+bool rotator_busy(rotator_t *rot)
+{
+    if (rot->active >= 0)
+    {
+        return true;
+    }
+
+    pthread_mutex_lock(&rot->lock);
+    bool pending = false;
+    for (int i = 0; i < ROT_NUM_AXES; i++)
+    {
+        pending |= rot->pending[i] || rot->query_pending[i];
+    }
+    pthread_mutex_unlock(&rot->lock);
+
+    return pending;
+}
+
+void rotator_get_latency(rotator_t *rot, rot_axis_t axis, axis_latency_t *latency)
+{
+    pthread_mutex_lock(&rot->lock);
+    *latency = rot->latency[axis];
+    pthread_mutex_unlock(&rot->lock);
+}
+
+/**
+ * @brief Takes the next pending request, alternating between axes so neither starves. Operator commands go first,
+ * then moves, then queries.
+ *
+ * @return true A command was started.
+ */
+static bool rotator_start(rotator_t *rot)
+{
+    double angle = 0;
+
+    pthread_mutex_lock(&rot->lock);
+    for (int pass = 0; pass < 2 && rot->active < 0; pass++)
+    {
+        for (int i = 1; i <= ROT_NUM_AXES; i++)
+        {
+            int axis = (rot->last_axis + i) % ROT_NUM_AXES;
+            if (rot->pending[axis] && (pass > 0 || rot->priority[axis]))
+            {
+                rot->active = axis;
+                rot->active_query = false;
+                rot->active_priority = rot->priority[axis];
+                angle = rot->target[axis];
+                rot->active_requested = rot->requested[axis];
+                rot->pending[axis] = false;
+                rot->priority[axis] = false;
+                break;
+            }
+        }
+    }
+    for (int i = 1; i <= ROT_NUM_AXES && rot->active < 0; i++)
+    {
+        int axis = (rot->last_axis + i) % ROT_NUM_AXES;
+        if (rot->query_pending[axis])
+        {
+            rot->active = axis;
+            rot->active_query = true;
+            rot->active_priority = false;
+            rot->query_pending[axis] = false;
+        }
+    }
+    pthread_mutex_unlock(&rot->lock);
+
+    if (rot->active < 0)
+    {
+        return false;
+    }
+    rot->last_axis = rot->active;
+    rot->sent = 0;
+
+    if (rot->active_query)
+    {
+        rot->command_len = format_query(rot->command, sizeof(rot->command), (rot_axis_t)rot->active);
+        return true;
+    }
+
+    if (rot->active == ROT_AZ)
+    {
+        rot->command_len = format_azimuth(rot->command, sizeof(rot->command), angle);
+    }
+    else
+    {
+        rot->command_len = format_elevation(rot->command, sizeof(rot->command), angle);
+    }
+
+    dbprintlf(GREEN_FG "COMMANDING %s (%.2f): %s", rot->active == ROT_AZ ? "AZ" : "EL", angle, rot->command);
+    return true;
+}
+
+int rotator_service(rotator_t *rot, struct timespec *next)
+{
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+
+    if (timespec_diff_ns(&rot->next_byte, &now) > 0)
+    {
+        *next = rot->next_byte;
+        return 0;
+    }
+
+    if (rot->active < 0 && !rotator_start(rot))
+    {
+        *next = now;
+        timespec_add_ns(next, rot->pacing);
+        return 0;
+    }
+
+#if defined(DISABLE_DEVICE)
+    ssize_t written = 1;
+#else
+    ssize_t written = write(rot->connection, rot->command + rot->sent, 1);
+#endif
+    if (written != 1)
+    {
+        dbprintlf(FATAL "Writing byte %d/%d of %s command, error %d", rot->sent + 1, rot->command_len, rot->active == ROT_AZ ? "AZ" : "EL", errno);
+        rot->active = -1;
+        rot->next_byte = now;
+        timespec_add_ns(&rot->next_byte, rot->pacing);
+        *next = rot->next_byte;
+        return -1;
+    }
+    rot->sent++;
+
+    if (rot->sent == 1 && !rot->active_query)
+    {
+        pthread_mutex_lock(&rot->lock);
+        rot->started[rot->active] = now;
+        pthread_mutex_unlock(&rot->lock);
+    }
+    if (rot->sent == 1 && rot->active_priority)
+    {
+        double latency = timespec_diff_ns(&now, &rot->active_requested) / 1e9;
+        pthread_mutex_lock(&rot->lock);
+        rot->preempts++;
+        rot->preempt_latency_sum += latency;
+        rot->preempt_latency_max = fmax(rot->preempt_latency_max, latency);
+        pthread_mutex_unlock(&rot->lock);
+        dbprintlf(YELLOW_FG "Operator %s command on the line %.1f ms after receipt (max %.1f ms over %" PRIu64 ").", rot->active == ROT_AZ ? "AZ" : "EL", latency * 1e3, rot->preempt_latency_max * 1e3, rot->preempts);
+    }
+
+    // Pace from the previous deadline so the byte period does not drift, unless the line has been idle.
+    if (timespec_diff_ns(&now, &rot->next_byte) > rot->pacing)
+    {
+        rot->next_byte = now;
+    }
+    timespec_add_ns(&rot->next_byte, rot->pacing);
+    *next = rot->next_byte;
+
+    if (rot->sent == rot->command_len)
+    {
+        if (!rot->active_query)
+        {
+            pthread_mutex_lock(&rot->lock);
+            axis_latency_record(&rot->latency[rot->active], timespec_diff_ns(&now, &rot->active_requested) / 1e9 * rot->time_scale);
+            rot->commands[rot->active]++;
+            rot->written[rot->active] = now;
+            pthread_mutex_unlock(&rot->lock);
+        }
+        rot->active = -1;
+    }
+
+    return 1;
+}
+
+void rotator_query(rotator_t *rot)
+{
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+
+    pthread_mutex_lock(&rot->lock);
+    for (int i = 0; i < ROT_NUM_AXES; i++)
+    {
+        if (!rot->query_pending[i] && timespec_diff_ns(&now, &rot->last_query[i]) * rot->time_scale >= ROT_QUERY_INTERVAL * NSEC_PER_SEC)
+        {
+            rot->query_pending[i] = true;
+            rot->last_query[i] = now;
+        }
+    }
+    pthread_mutex_unlock(&rot->lock);
+}
+
+int rotator_read(rotator_t *rot)
+{
+    int reports = 0;
+
+    for (;;)
+    {
+        ssize_t n = read(rot->connection, rot->rx + rot->rx_len, sizeof(rot->rx) - 1 - rot->rx_len);
+        if (n < 0 && errno != EAGAIN && errno != EWOULDBLOCK && errno != EINTR)
+        {
+            dbprintlf(RED_FG "Reading from rotator controller, error %d", errno);
+            return -1;
+        }
+        if (n <= 0)
+        {
+            break;
+        }
+        rot->rx_len += n;
+        rot->rx[rot->rx_len] = '\0';
+
+        struct timespec now;
+        clock_gettime(CLOCK_MONOTONIC, &now);
+
+        // Parse every complete line in place, keep the partial tail for the next read.
+        char *line = rot->rx;
+        char *end;
+        while ((end = strpbrk(line, "\r\n")) != nullptr)
+        {
+            *end = '\0';
+            rot_axis_t axis;
+            double angle;
+            if (parse_position(line, &axis, &angle) > 0)
+            {
+                pthread_mutex_lock(&rot->lock);
+                rot->measured[axis] = angle;
+                rot->measured_at[axis] = now;
+                rot->has_measured[axis] = true;
+                rot->reports[axis]++;
+                pthread_mutex_unlock(&rot->lock);
+                reports++;
+            }
+            line = end + 1;
+        }
+
+        rot->rx_len -= line - rot->rx;
+        memmove(rot->rx, line, rot->rx_len + 1);
+
+        // A line that never ends is noise.
+        if (rot->rx_len == (int)sizeof(rot->rx) - 1)
+        {
+            rot->rx_len = 0;
+        }
+    }
+
+    return reports;
+}
+
+bool rotator_get_measured(rotator_t *rot, rot_axis_t axis, double *angle, double *age)
+{
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+
+    pthread_mutex_lock(&rot->lock);
+    bool valid = rot->has_measured[axis];
+    *angle = rot->measured[axis];
+    double measured_age = timespec_diff_ns(&now, &rot->measured_at[axis]) / 1e9 * rot->time_scale;
+    pthread_mutex_unlock(&rot->lock);
+
+    if (age != nullptr)
+    {
+        *age = measured_age;
+    }
+    return valid && measured_age < ROT_FEEDBACK_STALE;
+}
+
+uint64_t rotator_get_writes(rotator_t *rot, rot_axis_t axis, struct timespec *started, struct timespec *written)
+{
+    pthread_mutex_lock(&rot->lock);
+    uint64_t commands = rot->commands[axis];
+    *started = rot->started[axis];
+    *written = rot->written[axis];
+    pthread_mutex_unlock(&rot->lock);
+
+    return commands;
+}
+
+double rotator_since_command(rotator_t *rot, rot_axis_t axis)
+{
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+
+    pthread_mutex_lock(&rot->lock);
+    double since = rot->commands[axis] ? timespec_diff_ns(&now, &rot->written[axis]) / 1e9 * rot->time_scale : -1;
+    pthread_mutex_unlock(&rot->lock);
+
+    return since;
+}
@@ -0,0 +1,112 @@
+/**
+ * @file rtloop.cpp
+ * @author Mit Bailey (mitbailey99@gmail.com)
+ * @brief
+ * @version See Git tags for version information.
+ * @date 2026.10.18
+ *
+ * @copyright Copyright (c) 2021
+ *
+ */
+
+#include <errno.h>
+#include <inttypes.h>
+#include <math.h>
+#include <string.h>
+#include "meb_debug.h"
+#include "rtloop.hpp"
+
+#define NSEC_PER_SEC 1000000000LL
+
+static int64_t timespec_to_ns(const struct timespec *ts)
+{
+    return ts->tv_sec * NSEC_PER_SEC + ts->tv_nsec;
+}
+
+static void ns_to_timespec(int64_t ns, struct timespec *ts)
+{
+    ts->tv_sec = ns / NSEC_PER_SEC;
+    ts->tv_nsec = ns % NSEC_PER_SEC;
+}
+
+int rt_loop_init(rt_loop_t *loop, int rate_hz)
+{
+    if (loop == nullptr || rate_hz < 1)
+    {
+        dbprintlf(RED_FG "Invalid loop rate %d Hz.", rate_hz);
+        return -1;
+    }
+
+    return rt_loop_init_period(loop, NSEC_PER_SEC / rate_hz);
+}
+
+int rt_loop_init_period(rt_loop_t *loop, int64_t period)
+{
+    if (loop == nullptr || period < 1)
+    {
+        dbprintlf(RED_FG "Invalid loop period %" PRId64 " ns.", period);
+        return -1;
+    }
+
+    memset(loop, 0, sizeof(rt_loop_t));
+    loop->period = period;
+
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    ns_to_timespec(timespec_to_ns(&now) + loop->period, &loop->deadline);
+
+    return 1;
+}
+
+int rt_loop_wait(rt_loop_t *loop)
+{
+    while (clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &loop->deadline, NULL) == EINTR)
+        ;
+
+    return rt_loop_tick(loop);
+}
+
+int rt_loop_tick(rt_loop_t *loop)
+{
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+
+    int64_t deadline = timespec_to_ns(&loop->deadline);
+    int64_t late = timespec_to_ns(&now) - deadline;
+
+    // Skip every period that has already passed instead of bursting to catch up.
+    int skipped = 0;
+    if (late >= loop->period)
+    {
+        skipped = late / loop->period;
+        deadline += skipped * loop->period;
+        late -= skipped * loop->period;
+        loop->stats.overruns += skipped;
+    }
+    ns_to_timespec(deadline + loop->period, &loop->deadline);
+
+    rt_loop_stats_t *stats = &loop->stats;
+    stats->cycles++;
+    if (stats->cycles == 1 || late < stats->jitter_min)
+    {
+        stats->jitter_min = late;
+    }
+    if (stats->cycles == 1 || late > stats->jitter_max)
+    {
+        stats->jitter_max = late;
+    }
+    double delta = late - stats->jitter_mean;
+    stats->jitter_mean += delta / stats->cycles;
+    stats->jitter_m2 += delta * (late - stats->jitter_mean);
+
+    return skipped;
+}
+
+double rt_loop_jitter_stddev(const rt_loop_stats_t *stats)
+{
+    if (stats->cycles < 2)
+    {
+        return 0;
+    }
+    return sqrt(stats->jitter_m2 / (stats->cycles - 1));
+}
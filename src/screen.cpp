@@ -0,0 +1,176 @@
+/**
+ * @file screen.cpp
+ * @author Mit Bailey (mitbailey99@gmail.com)
+ * @brief
+ * @version See Git tags for version information.
+ * @date 2026.10.18
+ *
+ * @copyright Copyright (c) 2021
+ *
+ */
+
+#include <math.h>
+#include <time.h>
+#include "Globals.h"
+#include "Util.h"
+#include "meb_debug.h"
+#include "screen.hpp"
+
+/**
+ * @brief Earth central angle between the site and the edge of the area from which an object at radius r is seen
+ * above elevation el.
+ *
+ * @param r Geocentric radius, kilometers.
+ * @param el Elevation, radians.
+ * @return double Radians, negative if the object can never be seen above el.
+ */
+static double coverage_angle(double r, double el)
+{
+    double c = kXKMPER * cos(el) / r;
+    if (c >= 1.0)
+    {
+        return -1.0;
+    }
+    return acos(c) - el;
+}
+
+/**
+ * @brief Two-body sub-satellite longitude at t, ignoring perturbations.
+ *
+ * @return double Radians, -pi to pi.
+ */
+static double kepler_longitude(const OrbitalElements &elements, const DateTime &t)
+{
+    double tsince = (t - elements.Epoch()).TotalMinutes();
+    double e = elements.Eccentricity();
+    double M = Util::WrapTwoPI(elements.MeanAnomoly() + elements.RecoveredMeanMotion() * tsince);
+
+    double E = M;
+    for (int i = 0; i < 10; i++)
+    {
+        E -= (E - e * sin(E) - M) / (1.0 - e * cos(E));
+    }
+
+    double nu = 2.0 * atan2(sqrt(1.0 + e) * sin(E / 2.0), sqrt(1.0 - e) * cos(E / 2.0));
+    double u = elements.ArgumentPerigee() + nu;
+    double raan = elements.AscendingNode();
+    double cosi = cos(elements.Inclination());
+
+    double x = cos(raan) * cos(u) - sin(raan) * sin(u) * cosi;
+    double y = sin(raan) * cos(u) + cos(raan) * sin(u) * cosi;
+
+    return Util::WrapNegPosPI(atan2(y, x) - t.ToGreenwichSiderealTime());
+}
+
+bool screen_elements(const OrbitalElements &elements, const CoordGeodetic &site, double min_elev, const DateTime &start, double window_min)
+{
+    double margin = Util::DegreesToRadians(SCREEN_ANGLE_MARGIN);
+    double el = Util::DegreesToRadians(min_elev);
+
+    // Widest coverage is reached at apogee.
+    double apogee = elements.RecoveredSemiMajorAxis() * (1.0 + elements.Eccentricity()) * kXKMPER + SCREEN_ALT_MARGIN;
+    double reach = coverage_angle(apogee, el);
+    if (reach < 0.0)
+    {
+        return false;
+    }
+    reach += margin;
+
+    // Orbital plane: the ground track never goes poleward of the inclination.
+    double incl = elements.Inclination();
+    double max_lat = incl > kPI / 2.0 ? kPI - incl : incl;
+    if (max_lat + reach < fabs(site.latitude))
+    {
+        return false;
+    }
+
+    // Longitude: only near-synchronous objects stay within a longitude band over the window.
+    if (max_lat > Util::DegreesToRadians(SCREEN_MAX_SYNC_INCL))
+    {
+        return true;
+    }
+
+    double drift = (elements.RecoveredMeanMotion() - kTWOPI * kOMEGA_E / kMINUTES_PER_DAY) * window_min;
+    double tan_half = tan(max_lat / 2.0);
+    double swing = 2.0 * (2.0 * elements.Eccentricity() + asin(tan_half * tan_half)) + margin;
+    double width = fabs(drift) + 2.0 * swing;
+    if (width >= kTWOPI)
+    {
+        return true;
+    }
+
+    double west = kepler_longitude(elements, start) - swing + (drift < 0.0 ? drift : 0.0);
+    double offset = Util::WrapTwoPI(site.longitude - west);
+    double dlon = 0.0;
+    if (offset > width)
+    {
+        dlon = fmin(offset - width, kTWOPI - offset);
+    }
+
+    // Closest approach of any point in the band to the site, over all reachable latitudes.
+    double sin_lat = sin(site.latitude);
+    double cos_term = cos(site.latitude) * cos(dlon);
+    double closest = acos(fmin(1.0, sqrt(sin_lat * sin_lat + cos_term * cos_term)));
+
+    return closest <= reach;
+}
+
+int screen_catalog(const catalog_t *catalog, Observer *dish, double min_elev, const DateTime &start, double window_min, std::vector<unsigned int> &visible)
+{
+    if (catalog == nullptr || dish == nullptr)
+    {
+        dbprintlf(RED_FG "Invalid screening arguments.");
+        return -1;
+    }
+
+    struct timespec tstart, tend;
+    clock_gettime(CLOCK_MONOTONIC, &tstart);
+
+    visible.clear();
+
+    CoordGeodetic site = dish->GetLocation();
+    std::vector<std::pair<unsigned int, const SGP4 *>> candidates;
+    for (const auto &it : catalog->entries)
+    {
+        if (screen_elements(it.second.model->Elements(), site, min_elev, start, window_min))
+        {
+            candidates.push_back(std::make_pair(it.first, it.second.model));
+        }
+    }
+    size_t num_candidates = candidates.size();
+
+    // Time outer, satellites inner, so the observer position is computed once per step.
+    double min_elev_rad = Util::DegreesToRadians(min_elev);
+    int steps = window_min * 60 / SCREEN_STEP_SEC;
+    for (int i = 0; i <= steps && candidates.size() > 0; i++)
+    {
+        DateTime t = start.AddSeconds(i * SCREEN_STEP_SEC);
+        for (size_t j = 0; j < candidates.size();)
+        {
+            Eci eci;
+            SGP4::Status status = candidates[j].second->FindPositionOnly(t, eci);
+            bool done = status != SGP4::OK;
+            if (!done && dish->GetElevation(eci) >= min_elev_rad)
+            {
+                visible.push_back(candidates[j].first);
+                done = true;
+            }
+
+            if (done)
+            {
+                candidates[j] = candidates.back();
+                candidates.pop_back();
+            }
+            else
+            {
+                j++;
+            }
+        }
+    }
+
+    clock_gettime(CLOCK_MONOTONIC, &tend);
+    double elapsed = (tend.tv_sec - tstart.tv_sec) * 1e3 + (tend.tv_nsec - tstart.tv_nsec) / 1e6;
+    dbprintlf(BLUE_FG "Screened %zu objects: %zu passed prefilter, %zu visible (%.1f ms).", catalog->entries.size(), num_candidates, visible.size(), elapsed);
+
+    return visible.size();
+}
@@ -0,0 +1,62 @@
+/**
+ * @file simclock.cpp
+ * @author Mit Bailey (mitbailey99@gmail.com)
+ * @brief
+ * @version See Git tags for version information.
+ * @date 2026.10.18
+ *
+ * @copyright Copyright (c) 2021
+ *
+ */
+
+#include <time.h>
+#include "meb_debug.h"
+#include "simclock.hpp"
+
+// Written once by simclock_init() before the tracker threads are created, read-only afterwards.
+static bool sim_enabled = false;
+static double sim_scale = 1.0;
+static struct timespec sim_mono_origin;
+static DateTime sim_origin;
+
+int simclock_init(double scale, const DateTime &start)
+{
+    if (scale < 1.0 || scale > SIMCLOCK_MAX_SCALE)
+    {
+        dbprintlf(RED_FG "Simulation speed must be 1 to %.0f.", SIMCLOCK_MAX_SCALE);
+        return -1;
+    }
+
+    clock_gettime(CLOCK_MONOTONIC, &sim_mono_origin);
+    sim_origin = start;
+    sim_scale = scale;
+    sim_enabled = true;
+
+    dbprintlf(YELLOW_FG "Simulated time from %s at %.0fx.", start.ToString().c_str(), scale);
+    return 1;
+}
+
+DateTime simclock_now()
+{
+    if (!sim_enabled)
+    {
+        return DateTime::Now(true);
+    }
+
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    double elapsed = (now.tv_sec - sim_mono_origin.tv_sec) + (now.tv_nsec - sim_mono_origin.tv_nsec) / 1e9;
+
+    return sim_origin.AddMicroseconds(elapsed * sim_scale * 1e6);
+}
+
+double simclock_scale()
+{
+    return sim_scale;
+}
+
+int64_t simclock_wall_ns(int64_t sim_ns)
+{
+    int64_t ns = sim_ns / sim_scale;
+    return ns > 0 ? ns : 1;
+}
@@ -0,0 +1,193 @@
+/**
+ * @file simrotator.cpp
+ * @author Mit Bailey (mitbailey99@gmail.com)
+ * @brief
+ * @version See Git tags for version information.
+ * @date 2026.10.18
+ *
+ * @copyright Copyright (c) 2021
+ *
+ */
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <termios.h>
+#include <unistd.h>
+#include "meb_debug.h"
+#include "simclock.hpp"
+#include "simrotator.hpp"
+
+/**
+ * @brief Acts on one line from the tracker: "PB nnn" / "PA nnn" move, "PB?" / "PA?" report.
+ *
+ */
+static void sim_rotator_handle(sim_rotator_t *sim, const char *line)
+{
+    char mnemonic;
+    char query;
+    int value;
+    int axis;
+
+    if (sscanf(line, " P%c%c", &mnemonic, &query) != 2 || (mnemonic != 'A' && mnemonic != 'B'))
+    {
+        return;
+    }
+    axis = mnemonic == 'B' ? ROT_AZ : ROT_EL;
+
+    if (query == '?')
+    {
+        pthread_mutex_lock(&sim->lock);
+        int position = (int)round(sim->axis[axis].output);
+        sim->queries++;
+        pthread_mutex_unlock(&sim->lock);
+
+        char reply[ROT_CMD_SIZE];
+        int len = snprintf(reply, sizeof(reply), "P%c %03d\r\n", mnemonic, position);
+        if (write(sim->master, reply, len) != len)
+        {
+            dbprintlf(RED_FG "Simulated rotator reply lost.");
+        }
+    }
+    else if (sscanf(line, " P%c %d", &mnemonic, &value) == 2)
+    {
+        pthread_mutex_lock(&sim->lock);
+        sim->target[axis] = value;
+        sim->commands++;
+        pthread_mutex_unlock(&sim->lock);
+    }
+}
+
+/**
+ * @brief Moves both axes up to the current simulated time.
+ *
+ */
+static void sim_rotator_advance(sim_rotator_t *sim)
+{
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    double elapsed = ((now.tv_sec - sim->last.tv_sec) + (now.tv_nsec - sim->last.tv_nsec) / 1e9) * simclock_scale();
+
+    int steps = elapsed / SIM_ROTATOR_STEP;
+    if (steps < 1)
+    {
+        return;
+    }
+    sim->last = now;
+
+    pthread_mutex_lock(&sim->lock);
+    for (int i = 0; i < steps; i++)
+    {
+        for (int axis = 0; axis < ROT_NUM_AXES; axis++)
+        {
+            axis_simulate(&sim->model[axis], sim->target[axis], SIM_ROTATOR_STEP, &sim->axis[axis]);
+        }
+    }
+    pthread_mutex_unlock(&sim->lock);
+}
+
+static void *sim_rotator_thread(void *args)
+{
+    sim_rotator_t *sim = (sim_rotator_t *)args;
+    struct pollfd pfd = {sim->master, POLLIN, 0};
+
+    while (sim->running)
+    {
+        if (poll(&pfd, 1, 1) > 0 && (pfd.revents & POLLIN))
+        {
+            ssize_t n = read(sim->master, sim->rx + sim->rx_len, sizeof(sim->rx) - 1 - sim->rx_len);
+            if (n > 0)
+            {
+                sim->rx_len += n;
+                sim->rx[sim->rx_len] = '\0';
+
+                char *line = sim->rx;
+                char *end;
+                while ((end = strpbrk(line, "\r\n")) != nullptr)
+                {
+                    *end = '\0';
+                    sim_rotator_handle(sim, line);
+                    line = end + 1;
+                }
+                sim->rx_len -= line - sim->rx;
+                memmove(sim->rx, line, sim->rx_len + 1);
+                if (sim->rx_len == (int)sizeof(sim->rx) - 1)
+                {
+                    sim->rx_len = 0;
+                }
+            }
+        }
+
+        sim_rotator_advance(sim);
+    }
+
+    return NULL;
+}
+
+int sim_rotator_start(sim_rotator_t *sim, double az, double el)
+{
+    sim->master = posix_openpt(O_RDWR | O_NOCTTY);
+    if (sim->master < 0 || grantpt(sim->master) < 0 || unlockpt(sim->master) < 0 || ptsname(sim->master) == NULL)
+    {
+        dbprintlf(RED_FG "Could not open a pty for the simulated rotator, error %d.", errno);
+        return -1;
+    }
+    snprintf(sim->devname, sizeof(sim->devname), "%s", ptsname(sim->master));
+
+    // Raw from the start, before the tracker configures its side.
+    sim->slave = open(sim->devname, O_RDWR | O_NOCTTY);
+    if (sim->slave < 0)
+    {
+        dbprintlf(RED_FG "Could not open %s, error %d.", sim->devname, errno);
+        close(sim->master);
+        return -1;
+    }
+    struct termios options[1];
+    tcgetattr(sim->slave, options);
+    cfmakeraw(options);
+    tcsetattr(sim->slave, TCSANOW, options);
+
+    pthread_mutex_init(&sim->lock, NULL);
+    sim->model[ROT_AZ] = {AZ_SLEW_RATE, AZ_ACCEL, AZ_BACKLASH, CMD_QUANTUM, CMD_MIN_INTERVAL};
+    sim->model[ROT_EL] = {EL_SLEW_RATE, EL_ACCEL, EL_BACKLASH, CMD_QUANTUM, CMD_MIN_INTERVAL};
+    sim->axis[ROT_AZ] = {az, 0, az};
+    sim->axis[ROT_EL] = {el, 0, el};
+    sim->target[ROT_AZ] = az;
+    sim->target[ROT_EL] = el;
+    sim->commands = 0;
+    sim->queries = 0;
+    sim->rx_len = 0;
+    clock_gettime(CLOCK_MONOTONIC, &sim->last);
+
+    sim->running = true;
+    if (pthread_create(&sim->tid, NULL, sim_rotator_thread, sim) != 0)
+    {
+        dbprintlf(RED_FG "Could not start the simulated rotator.");
+        close(sim->slave);
+        close(sim->master);
+        return -1;
+    }
+
+    dbprintlf(YELLOW_FG "Simulated rotator on %s.", sim->devname);
+    return 1;
+}
+
+void sim_rotator_position(sim_rotator_t *sim, double *az, double *el)
+{
+    pthread_mutex_lock(&sim->lock);
+    *az = sim->axis[ROT_AZ].output;
+    *el = sim->axis[ROT_EL].output;
+    pthread_mutex_unlock(&sim->lock);
+}
+
+void sim_rotator_stop(sim_rotator_t *sim)
+{
+    sim->running = false;
+    pthread_join(sim->tid, NULL);
+    close(sim->slave);
+    close(sim->master);
+}
@@ -0,0 +1,53 @@
+/**
+ * @file telemetry.cpp
+ * @author Mit Bailey (mitbailey99@gmail.com)
+ * @brief
+ * @version See Git tags for version information.
+ * @date 2026.10.18
+ *
+ * @copyright Copyright (c) 2021
+ *
+ */
+
+#include <stddef.h>
+#include "meb_debug.h"
+#include "telemetry.hpp"
+
+int telem_init(telem_t *telem, int rate_hz)
+{
+    if (telem == nullptr || rate_hz < 0 || rate_hz > TELEM_RATE_MAX)
+    {
+        dbprintlf(RED_FG "Invalid telemetry rate %d Hz.", rate_hz);
+        return -1;
+    }
+
+    telem->rate_hz = rate_hz;
+    telem->sequence = 0;
+    telem->frame.magic = TELEM_MAGIC;
+    telem->frame.version = TELEM_VERSION;
+    telem->frame.count = 0;
+    telem->frame.reserved = 0;
+    telem->frame.sequence = 0;
+
+    return 1;
+}
+
+bool telem_push(telem_t *telem, const telem_sample_t *sample)
+{
+    if (telem->frame.count < TELEM_BATCH)
+    {
+        telem->frame.samples[telem->frame.count++] = *sample;
+    }
+    return telem->frame.count == TELEM_BATCH;
+}
+
+int telem_size(const telem_t *telem)
+{
+    return offsetof(telem_frame_t, samples) + telem->frame.count * sizeof(telem_sample_t);
+}
+
+void telem_next(telem_t *telem)
+{
+    telem->frame.count = 0;
+    telem->frame.sequence = ++telem->sequence;
+}
@@ -10,17 +10,27 @@
  */
 
 #include <stdlib.h>
+#include <sys/ioctl.h>
 #include <sys/stat.h>
 #include <fcntl.h>
 #include <termios.h>
 #include <unistd.h>
 #include <errno.h>
+#include <inttypes.h>
 #include <string.h>
+#include <time.h>
+#include <pthread.h>
+#include <fstream>
+#include <sstream>
 #include "DateTime.h"
 #include "Observer.h"
 #include "SGP4.h"
+#include "Util.h"
 #include "meb_debug.h"
 #include "track.hpp"
+#include "evloop.hpp"
+#include "rtloop.hpp"
+#include "simclock.hpp"
 #include "network.hpp"
 #include "gpiodev/gpiodev.h"
 
@@ -58,19 +68,71 @@ int open_connection(char *devname)
 // PB = Azimuth Command
 // PA = Elevation Command
 
+double azimuth_to_wrap(double azimuth)
+{
+    double controller = azimuth + AZIM_ADJ;
+    while (controller < ROT_AZ_MIN)
+        controller += 360.0;
+    while (controller > ROT_AZ_MAX)
+        controller -= 360.0;
+
+    return controller - AZIM_ADJ;
+}
+
+int format_azimuth(char *command, int size, double azimuth)
+{
+    azimuth = azimuth_to_wrap(azimuth) + AZIM_ADJ;
+
+    return snprintf(command, size, "PB %03d\r\n", (int)(azimuth));
+}
+
+int format_elevation(char *command, int size, double elevation)
+{
+    return snprintf(command, size, "PA %03d\r\n", (int)(elevation));
+}
+
+// Queries are answered with a report in the same form as the command, e.g. "PB 123".
+int format_query(char *command, int size, rot_axis_t axis)
+{
+    return snprintf(command, size, "%s?\r\n", axis == ROT_AZ ? "PB" : "PA");
+}
+
+int parse_position(const char *reply, rot_axis_t *axis, double *angle)
+{
+    char mnemonic;
+    double value;
+    if (sscanf(reply, " P%c %lf", &mnemonic, &value) != 2)
+    {
+        return -1;
+    }
+
+    if (mnemonic == 'B')
+    {
+        *axis = ROT_AZ;
+        *angle = value - AZIM_ADJ;
+    }
+    else if (mnemonic == 'A')
+    {
+        *axis = ROT_EL;
+        *angle = value;
+    }
+    else
+    {
+        return -1;
+    }
+    return 1;
+}
+
 // Azimuth in DEGREES, takes 160 ms
 int aim_azimuth(int connection, double azimuth)
 {
 #if defined(DISABLE_DEVICE)
     dbprintlf(FATAL "Serial device not in use, simulation only");
 #else
-    azimuth += AZIM_ADJ;
-    azimuth = azimuth < 0 ? 360.0 + azimuth : azimuth;
-
     // Command the dish manuever azimuth.
     const int command_size = 0x10;
     char command[command_size];
-    snprintf(command, command_size, "PB %03d\r\n", (int)(azimuth));
+    format_azimuth(command, command_size, azimuth);
 
     dbprintlf(GREEN_FG "COMMANDING AZ (%.2f): %s", azimuth, command);
 
@@ -78,7 +140,7 @@ int aim_azimuth(int connection, double azimuth)
     {
         if (write(connection, command + i, 1) != 1)
         {
-            dbprintlf(FATAL "Writing byte %d/8 of AZ command, error");
+            dbprintlf(FATAL "Writing byte %d/8 of AZ command, error", i + 1);
             return -1;
         }
         usleep(20000);
@@ -96,7 +158,7 @@ int aim_elevation(int connection, double elevation)
     // Command the dish manuever elevation.
     const int command_size = 0x10;
     char command[command_size];
-    snprintf(command, command_size, "PA %03d\r\n", (int)(elevation));
+    format_elevation(command, command_size, elevation);
 
     dbprintlf(GREEN_FG "COMMANDING EL (%.2f): %s", elevation, command);
 
@@ -104,7 +166,7 @@ int aim_elevation(int connection, double elevation)
     {
         if (write(connection, command + i, 1) != 1)
         {
-            dbprintlf(FATAL "Writing byte %d/8 of AZ command, error");
+            dbprintlf(FATAL "Writing byte %d/8 of EL command, error", i + 1);
             return -1;
         }
         usleep(20000);
@@ -115,347 +177,1132 @@ int aim_elevation(int connection, double elevation)
 
 CoordTopocentric find_next_targetrise(SGP4 *target, Observer *dish)
 {
-    DateTime time(DateTime::Now(true));
-    while (dish->GetLookAngle(target->FindPosition(DateTime(time))).elevation < MIN_ELEV)
+    DateTime time(simclock_now());
+    Eci eci;
+
+    // Coarse search on position and elevation only, full look angle once risen.
+    while (target->FindPositionOnly(time, eci) == SGP4::OK && dish->GetElevation(eci) DEG < MIN_ELEV)
     {
         time = time + TimeSpan(0, 1, 0);
     }
 
-    return dish->GetLookAngle(target->FindPosition(DateTime(time)));
+    if (target->FindPosition(time, eci) != SGP4::OK)
+    {
+        return CoordTopocentric();
+    }
+    return dish->GetLookAngle(eci);
 }
 
-void *tracking_thread(void *args)
+/**
+ * @brief Catalog subscriber: copies new elements of the tracked satellite into the target, invalidating the pass
+ * table. A satellite dropped from the catalog keeps being tracked on its last elements.
+ *
+ */
+static void track_catalog_changed(const std::vector<catalog_change_t> &changes, void *ctx)
 {
-    dbprintlf(GREEN_FG "TRACKING THREAD STARTING");
-
-    global_data_t *global = (global_data_t *)args;
+    track_state_t *state = (track_state_t *)ctx;
 
-    while (global->connection < 3)
+    for (const catalog_change_t &change : changes)
     {
-        // Open a connection to the dish controller.
-        global->connection = open_connection(global->devname);
+        if (change.norad != state->norad)
+        {
+            continue;
+        }
 
-        if (global->connection < 3)
+        const catalog_entry_t *entry = catalog_find(state->catalog, change.norad);
+        if (entry == nullptr)
         {
-            dbprintlf(RED_FG "Device not found.");
-            usleep(5 SEC);
+            dbprintlf(YELLOW_FG "%u left the catalog, tracking on its last elements.", change.norad);
+            continue;
         }
+
+        *state->target = *entry->model;
+        // A counter of its own rather than the entry's generation, which starts over if the satellite is re-added.
+        state->target_generation++;
+        dbprintlf(GREEN_FG "New elements for %u, epoch %s.", change.norad, entry->epoch.ToString().c_str());
     }
+}
 
-    sleep(2);
-    if (global->resetAtInit)
+void track_init(track_state_t *state)
+{
+    std::istringstream builtin(std::string(TLE[0]) + "\n" + TLE[1] + "\n");
+    state->catalog = new catalog_t;
+    catalog_update_tle(state->catalog, builtin);
+    state->norad = Tle(TLE[0], TLE[1]).NoradNumber();
+    state->target = new SGP4(*catalog_find(state->catalog, state->norad)->model);
+    catalog_subscribe(state->catalog, track_catalog_changed, state);
+    state->dish = new Observer(GS_LAT, GS_LON, ELEV);
+
+    state->pending_az = false;
+    state->pending_el = false;
+    state->sat_viewable = false;
+    state->phase = TRACK_IDLE;
+    state->time = simclock_now();
+    state->sat_az = 0;
+    state->sat_el = 0;
+    state->sat_range_rate = 0;
+    state->override = false;
+
+    state->cmd_az = 0;
+    state->cmd_el = 90;
+
+    state->sleep_timer = 0;
+    state->sleep_timer_max = 0;
+
+    state->target_generation = 1;
+    pass_clear(state->pass);
+
+    state->error_sum = 0;
+    state->error_max = 0;
+    state->error_samples = 0;
+    state->gpio_count = 0;
+    state->gpio_dropped = 0;
+}
+
+/**
+ * @brief Notes a GPIO transition for the flight recorder.
+ *
+ */
+static void track_gpio_event(track_state_t *state, int pin, flightrec_gpio_kind_t kind)
+{
+    if (state->gpio_count < FLIGHTREC_GPIO_MAX)
     {
-        aim_azimuth(global->connection, -AZIM_ADJ);
-        usleep(20000);
-        aim_elevation(global->connection, 90);
-        for (int i = 60; i > 0; i--)
-        {
-            dbprintlf(RED_FG "Init: Sleep remaining %d seconds", i);
-            sleep(1);
-        }
+        state->gpio[state->gpio_count].pin = pin;
+        state->gpio[state->gpio_count].kind = kind;
+        state->gpio_count++;
+    }
+    else
+    {
+        state->gpio_dropped++;
     }
+}
 
-    char biasctrl_status = 0;
-    if ((biasctrl_status = system("biasctrl -r") >> 8) < 0)
+// The pins are only switched when driving the real dish, a simulation still records the transitions.
+static void track_gpio_mode(global_data_t *global, track_state_t *state, int pin, int mode)
+{
+    if (global->sim == nullptr)
     {
-        dbprintlf(FATAL "Could not reset bias controller, exiting, code %d", biasctrl_status);
-        exit(0);
+        gpioSetMode(pin, mode);
     }
-    if ((biasctrl_status = system("biasctrl -s -3.0") >> 8) < 0)
+    track_gpio_event(state, pin, mode == GPIO_OUT ? FLIGHTREC_GPIO_OUT : FLIGHTREC_GPIO_IN);
+}
+
+static void track_gpio_write(global_data_t *global, track_state_t *state, int pin, int level)
+{
+    if (global->sim == nullptr)
     {
-        dbprintlf(FATAL "Could not reset bias voltage, exiting, code %d", biasctrl_status);
-        exit(0);
+        gpioWrite(pin, level);
     }
+    track_gpio_event(state, pin, level == GPIO_HIGH ? FLIGHTREC_GPIO_HIGH : FLIGHTREC_GPIO_LOW);
+}
 
-    SGP4 *target = new SGP4(Tle(TLE[0], TLE[1]));
-    Observer *dish = new Observer(GS_LAT, GS_LON, ELEV);
+/**
+ * @brief Scheduled commands (or planned axis angles) at t when the pass plan covers t, otherwise the look angle from
+ * SGP4 on the cable wrap.
+ *
+ * @return false The elements could not be propagated to t, az and el are left as they were.
+ */
+static bool track_look_angle(track_state_t *state, const DateTime &t, double *az, double *el)
+{
+    pass_sample_t sample;
+    if (pass_is_current(state->pass, state->target, state->target_generation, t) && pass_lookup(state->pass, t, &sample) > 0)
+    {
+        *az = state->pass->scheduled ? sample.az_cmd : sample.az_wrap;
+        *el = state->pass->scheduled ? sample.el_cmd : sample.el_axis;
+        return true;
+    }
 
-    bool pending_az = false;
-    bool pending_el = false;
-    bool pending_any = false;
+    Eci eci;
+    if (state->target->FindPosition(t, eci) != SGP4::OK)
+    {
+        return false;
+    }
+    CoordTopocentric look = state->dish->GetLookAngle(eci);
+    *az = azimuth_to_wrap(look.azimuth DEG);
+    *el = look.elevation DEG;
+    return true;
+}
 
-    bool sat_viewable = false;
+/**
+ * @brief Builds the pass table from start, plans its axis path (flip, keyhole swing, cable wrap) from where the
+ * dish is now, and schedules the commands along it.
+ *
+ */
+static void track_build_pass(global_data_t *global, track_state_t *state, const DateTime &start, bool prepositioned)
+{
+    static const axis_model_t az_model = {AZ_SLEW_RATE, AZ_ACCEL, AZ_BACKLASH, CMD_QUANTUM, CMD_MIN_INTERVAL};
+    static const axis_model_t el_model = {EL_SLEW_RATE, EL_ACCEL, EL_BACKLASH, CMD_QUANTUM, CMD_MIN_INTERVAL};
 
-    double cmd_az = 0;
-    double cmd_el = M_PI_2;
+    if (pass_build(state->pass, state->target, state->target_generation, state->dish, start, MIN_ELEV) < 0)
+    {
+        return;
+    }
+
+    double current_az, current_el;
+    if (!rotator_get_measured(global->rotator, ROT_AZ, &current_az, nullptr))
+    {
+        current_az = state->cmd_az;
+    }
+    if (!rotator_get_measured(global->rotator, ROT_EL, &current_el, nullptr))
+    {
+        current_el = state->cmd_el;
+    }
+    if (pass_plan_pointing(state->pass, current_az, ROT_AZ_MIN - AZIM_ADJ, ROT_AZ_MAX - AZIM_ADJ, ROT_EL_MAX, AZ_SLEW_RATE) < 0)
+    {
+        return;
+    }
 
-    int sleep_timer = 0;
-    int sleep_timer_max = 0;
+    // A pre-positioned dish is already waiting at the start of the path.
+    const pass_sample_t *first = &state->pass->samples[0];
+    pass_plan_commands(state->pass, &az_model, &el_model, prepositioned ? first->az_wrap : current_az, prepositioned ? first->el_axis : current_el);
+}
 
-    for (;;)
+/**
+ * @brief Decides whether an axis needs a command to follow target.
+ *
+ * Without fresh feedback this is the open-loop deadband on the last command (half a step when following a
+ * command schedule). With it, nothing is sent while the
+ * dish is within POINT_TOLERANCE of the target, and the current command is only repeated once the dish has had
+ * time to get there.
+ */
+static bool track_axis_due(rotator_t *rot, rot_axis_t axis, double cmd, double target, double deadband, const axis_latency_t *latency)
+{
+    // Azimuths are all on the cable wrap, so a plain difference is the travel.
+    double cmd_error = fabs(target - cmd);
+
+    double measured;
+    if (!rotator_get_measured(rot, axis, &measured, nullptr))
     {
-        // Step 1: Execute command
-        pending_any = pending_az | pending_el;
+        return cmd_error > deadband;
+    }
 
-        if (pending_az)
-            aim_azimuth(global->connection, cmd_az); // 160 ms
-        else
-            usleep(160000);
+    double error = fabs(target - measured);
+    if (error <= POINT_TOLERANCE)
+    {
+        return false;
+    }
+    if (cmd_error > fmin(deadband, POINT_TOLERANCE))
+    {
+        return true;
+    }
 
-        pending_az = false;
-        if (pending_el)
-            aim_elevation(global->connection, cmd_el); // 160 ms
-        else
-            usleep(160000);
-
-        pending_el = false;
-        usleep(100000);
-        if (pending_any) // any change, send over network
-        {
-            global->AzEl[0] = cmd_az;
-            global->AzEl[1] = cmd_el;
-            NetFrame *network_frame = new NetFrame((unsigned char *)global->AzEl, sizeof(global->AzEl), NetType::TRACKING_DATA, NetVertex::CLIENT);
-            network_frame->sendFrame(global->network_data);
-            delete network_frame;
-        }
-        // Now we have 680000 us left
-        usleep(580000);
-        // Determine position of satellite NOW
-        DateTime tnow = DateTime::Now(true);
-        Eci pos_now = target->FindPosition(tnow);
+    double since = rotator_since_command(rot, axis);
+    return since < 0 || since > latency->response_time + error / latency->slew_rate;
+}
+
+/**
+ * @brief Angle between where the simulated dish points and where the satellite is, accumulated over the pass.
+ *
+ */
+static void track_measure_error(global_data_t *global, track_state_t *state, const DateTime &t)
+{
+    double dish_az, dish_el;
+    sim_rotator_position(global->sim, &dish_az, &dish_el);
+    dish_az -= AZIM_ADJ;
+    if (dish_el > 90.0)
+    {
+        dish_az += 180.0;
+        dish_el = 180.0 - dish_el;
+    }
+
+    Eci eci;
+    if (state->target->FindPosition(t, eci) != SGP4::OK)
+    {
+        return;
+    }
+    CoordTopocentric look = state->dish->GetLookAngle(eci);
+    double az1 = Util::DegreesToRadians(dish_az), el1 = Util::DegreesToRadians(dish_el);
+    double cos_sep = sin(el1) * sin(look.elevation) + cos(el1) * cos(look.elevation) * cos(az1 - look.azimuth);
+    double error = acos(fmax(-1.0, fmin(1.0, cos_sep))) DEG;
+
+    state->error_sum += error;
+    state->error_max = fmax(state->error_max, error);
+    state->error_samples++;
+}
+
+void track_step(global_data_t *global, track_state_t *state)
+{
+    SGP4 *target = state->target;
+    Observer *dish = state->dish;
+    int rate = global->track_rate_hz;
+    state->gpio_count = 0;
+    state->gpio_dropped = 0;
+
+    // Determine position of satellite NOW
+    DateTime tnow = simclock_now();
+    double cur_az, cur_el, cur_el_axis; // degrees, azimuth on the cable wrap
+    pass_sample_t now_sample;
+    if (pass_is_current(state->pass, target, state->target_generation, tnow) && pass_lookup(state->pass, tnow, &now_sample) > 0)
+    {
+        cur_az = now_sample.az_wrap;
+        cur_el = now_sample.el;
+        cur_el_axis = now_sample.el_axis;
+        state->sat_az = now_sample.az;
+        state->sat_range_rate = now_sample.range_rate;
+        dbprintlf(BLUE_BG "Current Position: %.2f AZ, %.2f EL | %.3f km/s", now_sample.az, cur_el, now_sample.range_rate);
+    }
+    else
+    {
+        // Propagation failures (e.g. decayed elements) skip the cycle rather than end the event loop.
+        Eci pos_now;
+        if (target->FindPosition(tnow, pos_now) != SGP4::OK)
+        {
+            dbprintlf(RED_FG "Could not propagate %u to %s, skipping the cycle.", state->norad, tnow.ToString().c_str());
+            return;
+        }
         CoordTopocentric current_pos = dish->GetLookAngle(pos_now);
         CoordGeodetic current_lla = pos_now.ToGeodetic();
-        dbprintlf(BLUE_BG "Current Position: %.2f AZ, %.2f EL | %.2f LA, %.2f LN", current_pos.azimuth DEG, current_pos.elevation DEG, current_lla.latitude DEG, current_lla.longitude DEG);
-        if (sleep_timer)
+        cur_az = azimuth_to_wrap(current_pos.azimuth DEG);
+        cur_el = current_pos.elevation DEG;
+        cur_el_axis = cur_el;
+        state->sat_az = current_pos.azimuth DEG;
+        state->sat_range_rate = current_pos.range_rate;
+        state->sat_eci = pos_now;
+        dbprintlf(BLUE_BG "Current Position: %.2f AZ, %.2f EL | %.2f LA, %.2f LN", current_pos.azimuth DEG, cur_el, current_lla.latitude DEG, current_lla.longitude DEG);
+    }
+    state->sat_el = cur_el;
+    state->time = tnow;
+
+    // An operator command holds the dish, the pass state is picked up again where it stands when the hold ends.
+    if (state->override)
+    {
+        struct timespec now;
+        clock_gettime(CLOCK_MONOTONIC, &now);
+        if (now.tv_sec < state->override_until.tv_sec || (now.tv_sec == state->override_until.tv_sec && now.tv_nsec < state->override_until.tv_nsec))
         {
-            if (sleep_timer > sleep_timer_max) // update max
-                sleep_timer_max = sleep_timer;
-            if ((sleep_timer_max - sleep_timer) < 20) // for 20 seconds command parking
+            // Keep counting down a pre-positioning wait so the pass is still picked up at rise.
+            if (state->sleep_timer > 0)
             {
-                pending_az = true;
-                pending_el = true;
+                state->sleep_timer--;
             }
-            sleep_timer--;
-            dbprintlf(BLUE_FG "Will be sleeping for %d more seconds...", sleep_timer);
-            continue;
+            return;
+        }
+        state->override = false;
+        state->phase = state->override_phase;
+        dbprintlf(YELLOW_FG "Operator hold expired, resuming autotrack.");
+    }
+    if (state->sleep_timer)
+    {
+        if (state->sleep_timer > state->sleep_timer_max) // update max
+            state->sleep_timer_max = state->sleep_timer;
+        int slept = state->sleep_timer_max - state->sleep_timer;
+        if (slept < 20 * rate && slept % rate == 0) // for 20 seconds command parking, once a second
+        {
+            state->pending_az = true;
+            state->pending_el = true;
+        }
+        state->sleep_timer--;
+        if (state->sleep_timer % rate == 0)
+        {
+            dbprintlf(BLUE_FG "Will be sleeping for %d more seconds...", state->sleep_timer / rate);
+        }
+        return;
+    }
+    else
+    {
+        state->sleep_timer_max = 0;
+    }
+    // Step 2: Are we in a pass?
+    if (cur_el > MIN_ELEV)
+    {
+        if (!state->sat_viewable) // satellite just became visible
+        {
+            track_gpio_mode(global, state, 15, GPIO_OUT);
+            track_gpio_write(global, state, 15, GPIO_LOW);
+        }
+        state->sat_viewable = true;
+        state->phase = TRACK_PASS;
+
+        if (global->sim != nullptr)
+        {
+            track_measure_error(global, state, tnow);
+        }
+
+        // Normally built at pre-positioning, this covers starting mid-pass and new elements.
+        if (!pass_is_current(state->pass, target, state->target_generation, tnow))
+        {
+            track_build_pass(global, state, tnow, false);
+        }
+
+        // Aim where the satellite will be once each command has taken effect. The measured write time includes
+        // any wait behind the other axis in the writer queue.
+        axis_latency_t az_latency, el_latency;
+        rotator_get_latency(global->rotator, ROT_AZ, &az_latency);
+        rotator_get_latency(global->rotator, ROT_EL, &el_latency);
+        double az_lead, el_lead, deadband;
+        if (pass_is_current(state->pass, target, state->target_generation, tnow) && state->pass->scheduled)
+        {
+            // The schedule already allows for the motion, lead only by the command latency.
+            az_lead = az_latency.write_time + az_latency.response_time;
+            el_lead = el_latency.write_time + el_latency.response_time;
+            deadband = CMD_QUANTUM / 2.0;
         }
         else
         {
-            sleep_timer_max = 0;
+            az_lead = axis_latency_predict(&az_latency, cur_az - state->cmd_az);
+            el_lead = axis_latency_predict(&el_latency, cur_el_axis - state->cmd_el);
+            deadband = 1;
         }
-        // Step 2: Are we in a pass?
-        if (current_pos.elevation DEG > MIN_ELEV)
+        double lead_az = cur_az, lead_el = cur_el_axis, unused;
+        track_look_angle(state, tnow.AddSeconds(az_lead), &lead_az, &unused);
+        track_look_angle(state, tnow.AddSeconds(el_lead), &unused, &lead_el);
+        dbprintlf(BLUE_FG "Leading %.2f s AZ (%.2f), %.2f s EL (%.2f)", az_lead, lead_az, el_lead, lead_el);
+
+        if (track_axis_due(global->rotator, ROT_AZ, state->cmd_az, lead_az, deadband, &az_latency))
         {
-            if (!sat_viewable) // satellite just became visible
-            {
-                gpioSetMode(15, GPIO_OUT);
-                gpioWrite(15, GPIO_LOW);
-            }
-            sat_viewable = true;
-            if (fabs(cmd_az DEG - current_pos.azimuth DEG) > 1) // azimuth has changed
-            {
-                cmd_az = current_pos.azimuth DEG;
-                pending_az = true;
-            }
-            if (fabs(cmd_el DEG - current_pos.elevation DEG) > 1)
-            {
-                cmd_el = current_pos.elevation DEG;
-                pending_el = true;
-            }
-            continue;
+            state->cmd_az = lead_az;
+            state->pending_az = true;
         }
-        // Step 3: Were we in a pass?
-        if (sat_viewable) // we are here, but sat_viewable is on. Meaning we just got out of a pass
-        {
-            sat_viewable = false;
-            cmd_az = -AZIM_ADJ;
-            cmd_el = 90;
-            pending_az = true;
-            pending_el = true;
-            sleep_timer = 120; // 120 seconds
-            gpioSetMode(15, GPIO_IN); // set packet output to high Z
-            gpioSetMode(18, GPIO_IN); // set PA VDD to high Z
-        }
-        sat_viewable = false;
-        // Step 4: Projection
-        DateTime tnext = tnow;
+        if (track_axis_due(global->rotator, ROT_EL, state->cmd_el, lead_el, deadband, &el_latency))
+        {
+            state->cmd_el = lead_el;
+            state->pending_el = true;
+        }
+        return;
+    }
+    // Step 3: Were we in a pass?
+    if (state->sat_viewable) // we are here, but sat_viewable is on. Meaning we just got out of a pass
+    {
+        state->sat_viewable = false;
+        if (state->error_samples > 0)
+        {
+            dbprintlf(YELLOW_FG "Pass pointing error: %.2f deg mean, %.2f deg max over %" PRIu64 " cycles.", state->error_sum / state->error_samples, state->error_max, state->error_samples);
+            state->error_sum = 0;
+            state->error_max = 0;
+            state->error_samples = 0;
+        }
+        state->cmd_az = -AZIM_ADJ;
+        state->cmd_el = 90;
+        state->pending_az = true;
+        state->pending_el = true;
+        state->sleep_timer = 120 * rate; // 120 seconds
+        state->phase = TRACK_PARKING;
+        track_gpio_mode(global, state, 15, GPIO_IN); // set packet output to high Z
+        track_gpio_mode(global, state, 18, GPIO_IN); // set PA VDD to high Z
+    }
+    state->sat_viewable = false;
+    // Step 4: Projection
+    if (state->sleep_timer == 0)
+    {
+        state->phase = TRACK_IDLE;
+    }
+    DateTime tnext = tnow;
 #define LOOKAHEAD_MIN 2
 #define LOOKAHEAD_MAX 4
-        tnext = tnext.AddMinutes(LOOKAHEAD_MAX); // 4 minutes lookahead
-        for (int i = 0; i < (LOOKAHEAD_MAX - LOOKAHEAD_MIN) * 60; i++)
-        {
-            Eci eci_ahd = target->FindPosition(tnext);
-            CoordTopocentric pos_ahd = dish->GetLookAngle(eci_ahd);
-            if (i == 0)
-                dbprintlf(GREEN_BG "Lookahead %d: %.2f AZ %.2f EL", i, pos_ahd.azimuth DEG, pos_ahd.elevation DEG);
-            int ahd_el = pos_ahd.elevation DEG;
-            if (ahd_el < (int)MIN_ELEV) // still not in view 4 minutes ahead, don't care
-            {
-                break;
-            }
-            if (ahd_el > (int)MIN_ELEV) // already up, find where it is at proper elevation
-            {
-                tnext = tnext.AddSeconds(-1);
-            }
-            else // right point
-            {
-                cmd_az = pos_ahd.azimuth DEG;
-                cmd_el = pos_ahd.elevation DEG;
-                pending_az = true;
-                pending_el = true;
-                sleep_timer = LOOKAHEAD_MAX * 60 - i; // lookahead left
-                gpioSetMode(18, GPIO_OUT);            // set PA VDD EN to output
-                gpioWrite(18, GPIO_HIGH);             // enable PA VDD
-                break;                                // break inner for loop
-            }
+    tnext = tnext.AddMinutes(LOOKAHEAD_MAX); // 4 minutes lookahead
+    for (int i = 0; i < (LOOKAHEAD_MAX - LOOKAHEAD_MIN) * 60; i++)
+    {
+        // Screening only needs the elevation, the full look angle is taken at the rise point.
+        Eci eci_ahd;
+        if (target->FindPositionOnly(tnext, eci_ahd) != SGP4::OK)
+        {
+            break;
+        }
+        double ahd_el_deg = dish->GetElevation(eci_ahd) DEG;
+        if (i == 0)
+        {
+            dbprintlf(GREEN_BG "Lookahead %d: %.2f EL", i, ahd_el_deg);
+        }
+        int ahd_el = ahd_el_deg;
+        if (ahd_el < (int)MIN_ELEV) // still not in view 4 minutes ahead, don't care
+        {
+            break;
+        }
+        if (ahd_el > (int)MIN_ELEV) // already up, find where it is at proper elevation
+        {
+            tnext = tnext.AddSeconds(-1);
+        }
+        else // right point
+        {
+            // Pre-position on the wrap planned for the whole pass.
+            track_build_pass(global, state, tnext, true);
+            track_look_angle(state, tnext, &state->cmd_az, &state->cmd_el);
+            state->pending_az = true;
+            state->pending_el = true;
+            state->sleep_timer = (LOOKAHEAD_MAX * 60 - i) * rate; // lookahead left
+            state->phase = TRACK_PREPOSITION;
+            track_gpio_mode(global, state, 18, GPIO_OUT);          // set PA VDD EN to output
+            track_gpio_write(global, state, 18, GPIO_HIGH);        // enable PA VDD
+            break;                                                 // break inner for loop
         }
     }
+}
+
+bool track_execute(global_data_t *global, track_state_t *state)
+{
+    // Parking and pre-positioning repeat their commands, skip them once the dish reports being there.
+    double measured;
+    if (state->pending_az && rotator_get_measured(global->rotator, ROT_AZ, &measured, nullptr) && fabs(state->cmd_az - measured) <= POINT_TOLERANCE)
+        state->pending_az = false;
+    if (state->pending_el && rotator_get_measured(global->rotator, ROT_EL, &measured, nullptr) && fabs(state->cmd_el - measured) <= POINT_TOLERANCE)
+        state->pending_el = false;
 
-    delete dish;
-    delete target;
-    close(global->connection);
+    bool pending_any = state->pending_az | state->pending_el;
 
-    dbprintlf(RED_BG "TRACKING THREAD EXITING");
-    if (global->network_data->thread_status > 0)
+    // Only queues the commands, the writer thread does the byte pacing.
+    if (state->pending_az)
+        rotator_command(global->rotator, ROT_AZ, state->cmd_az);
+    state->pending_az = false;
+
+    if (state->pending_el)
+        rotator_command(global->rotator, ROT_EL, state->cmd_el);
+    state->pending_el = false;
+
+    return pending_any;
+}
+
+/**
+ * @brief Takes an axis position off the cable wrap and out of a flip, to 0 to 360 azimuth and 0 to 90 elevation.
+ *
+ */
+static void track_to_sky(double *az, double *el)
+{
+    if (*el > 90.0)
     {
-        global->network_data->thread_status = 0;
+        *az += 180.0;
+        *el = 180.0 - *el;
     }
-    return NULL;
+    *az = fmod(*az, 360.0);
+    *az = *az < 0 ? *az + 360.0 : *az;
 }
 
-void *gs_network_rx_thread(void *args)
+void track_send_status(global_data_t *global)
 {
-    dbprintlf(GREEN_FG "GS NETWORK RX THREAD STARTING");
+    double AzEl[2] = {global->state.az, global->state.el};
+    track_send_frame(global, NetType::TRACKING_DATA, AzEl, sizeof(AzEl));
+}
 
-    global_data_t *global = (global_data_t *)args;
-    NetDataClient *network_data = global->network_data;
+void track_snapshot(global_data_t *global, const track_state_t *state, uint64_t cycle, track_snapshot_t *snapshot)
+{
+    snapshot->time_us = (state->time.Ticks() - UnixEpoch) / TicksPerMicrosecond;
+    snapshot->cycle = cycle;
+    snapshot->norad = state->norad;
+    snapshot->phase = state->phase;
+    snapshot->flags = 0;
+    snapshot->reserved = 0;
+
+    snapshot->cmd_az = state->cmd_az;
+    snapshot->cmd_el = state->cmd_el;
+    track_to_sky(&snapshot->cmd_az, &snapshot->cmd_el);
+
+    snapshot->az = state->cmd_az;
+    snapshot->el = state->cmd_el;
+    if (rotator_get_measured(global->rotator, ROT_AZ, &snapshot->az, nullptr))
+    {
+        snapshot->flags |= TRACKSHM_AZ_MEASURED;
+    }
+    if (rotator_get_measured(global->rotator, ROT_EL, &snapshot->el, nullptr))
+    {
+        snapshot->flags |= TRACKSHM_EL_MEASURED;
+    }
+    track_to_sky(&snapshot->az, &snapshot->el);
+
+    snapshot->sat_az = state->sat_az;
+    snapshot->sat_el = state->sat_el;
+    snapshot->range_rate = state->sat_range_rate;
+}
+
+void track_record(global_data_t *global, track_state_t *state, const track_snapshot_t *snapshot, flightrec_record_t *record)
+{
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    record->mono_ns = now.tv_sec * 1000000000LL + now.tv_nsec;
+    record->snapshot = *snapshot;
+
+    if (state->sat_eci.GetDateTime() != state->time)
+    {
+        state->target->FindPosition(state->time, state->sat_eci);
+    }
+    Vector position = state->sat_eci.Position();
+    Vector velocity = state->sat_eci.Velocity();
+    record->eci_position[0] = position.x;
+    record->eci_position[1] = position.y;
+    record->eci_position[2] = position.z;
+    record->eci_velocity[0] = velocity.x;
+    record->eci_velocity[1] = velocity.y;
+    record->eci_velocity[2] = velocity.z;
+
+    record->cmd_az = state->cmd_az;
+    record->cmd_el = state->cmd_el;
+    for (int i = 0; i < ROT_NUM_AXES; i++)
+    {
+        struct timespec started, written;
+        record->commands[i] = rotator_get_writes(global->rotator, (rot_axis_t)i, &started, &written);
+        record->write_start_ns[i] = started.tv_sec * 1000000000LL + started.tv_nsec;
+        record->write_end_ns[i] = written.tv_sec * 1000000000LL + written.tv_nsec;
+    }
+
+    record->gpio_count = state->gpio_count;
+    record->gpio_dropped = state->gpio_dropped;
+    memcpy(record->gpio, state->gpio, sizeof(record->gpio));
+    memset(record->reserved, 0, sizeof(record->reserved));
+}
+
+ssize_t track_send_frame(global_data_t *global, NetType type, const void *payload, int size)
+{
+    // Lives on the stack for the send only; the payload is already serialized by the caller. The frame format
+    // belongs to the network library, which copies the payload into a buffer of its own.
+    NetFrame frame((unsigned char *)payload, size, type, NetVertex::CLIENT);
+    ssize_t sent = frame.sendFrame(global->network_data);
+
+    // The server acknowledges status frames; telemetry and stats are fire and forget.
+    netstats_sent(global->netstats, (int)type, sent, type == NetType::TRACKING_DATA);
+    return sent;
+}
+
+int track_override(global_data_t *global, track_state_t *state, double az, double el, const struct timespec *received)
+{
+    if (!(az >= 0 && az <= 360.0 && el >= 0 && el <= 90.0))
+    {
+        dbprintlf(RED_FG "Operator command %.2f AZ, %.2f EL out of range, ignored.", az, el);
+        return -1;
+    }
+
+    state->cmd_az = azimuth_to_wrap(az);
+    state->cmd_el = el;
+    state->pending_az = false;
+    state->pending_el = false;
+    rotator_preempt(global->rotator, ROT_AZ, state->cmd_az, received);
+    rotator_preempt(global->rotator, ROT_EL, state->cmd_el, received);
+
+    if (!state->override)
+    {
+        state->override_phase = state->phase;
+    }
+    state->override = true;
+    clock_gettime(CLOCK_MONOTONIC, &state->override_until);
+    int64_t hold = simclock_wall_ns(TRACK_OVERRIDE_HOLD * 1000000000LL);
+    state->override_until.tv_sec += hold / 1000000000LL;
+    state->override_until.tv_nsec += hold % 1000000000LL;
+    if (state->override_until.tv_nsec >= 1000000000LL)
+    {
+        state->override_until.tv_sec++;
+        state->override_until.tv_nsec -= 1000000000LL;
+    }
+    state->phase = TRACK_MANUAL;
+
+    dbprintlf(YELLOW_FG "Operator override to %.2f AZ, %.2f EL, autotrack resumes in %d s.", az, el, TRACK_OVERRIDE_HOLD);
+    return 1;
+}
+
+void track_handle_frame(global_data_t *global, track_state_t *state, NetFrame *netframe, const struct timespec *received)
+{
+#if LOG_LEVEL <= LOG_DEBUG
+    // The library prints synchronously, keep it to debug builds.
+    dbprintlf("Received the following NetFrame:");
+    netframe->print();
+    netframe->printNetstat();
+#endif
 
-    // Similar, if not identical, to the network functionality in ground_station.
-    // Roof UHF is a network client to the GS Server, and so should be very similar in socketry to ground_station.
+    // Copied out of the frame once, handlers read typed views of it.
+    alignas(double) unsigned char payload[TRACK_RX_PAYLOAD_SIZE];
+    int payload_size = netframe->getPayloadSize();
+    if (payload_size < 0 || payload_size > (int)sizeof(payload) || netframe->retrievePayload(payload, sizeof(payload)) < 0)
+    {
+        dbprintlf(RED_FG "Error retrieving data.");
+        return;
+    }
 
-    while (network_data->recv_active && global->network_data->thread_status > 0)
+    switch (netframe->getType())
+    {
+    case NetType::TRACKING_COMMAND:
     {
-        if (!network_data->connection_ready)
+        dbprintlf(BLUE_FG "Received a tracking command.");
+
+        if (payload_size != 2 * sizeof(double))
         {
-            usleep(5 SEC);
-            continue;
+            dbprintlf(RED_FG "Tracking command of %d bytes, expected %zu.", payload_size, 2 * sizeof(double));
+            break;
+        }
+        const double *AzEl = (const double *)payload;
+        dbprintlf(BLUE_FG "Requested %.2f AZ, %.2f EL.", AzEl[0], AzEl[1]);
+        if (track_override(global, state, AzEl[0], AzEl[1], received) < 0)
+        {
+            track_send_status(global);
+            break;
         }
 
-        int read_size = 0;
+        // Reply with the pointing just commanded, global->state still holds the previous cycle.
+        double reply[2] = {state->cmd_az, state->cmd_el};
+        track_to_sky(&reply[0], &reply[1]);
+        track_send_frame(global, NetType::TRACKING_DATA, reply, sizeof(reply));
+        break;
+    }
+    case NetType::ACK:
+    {
+        break;
+    }
+    case NetType::NACK:
+    {
+        break;
+    }
+    default:
+    {
+        break;
+    }
+    }
+}
 
-        while (read_size >= 0 && network_data->recv_active && network_data->thread_status > 0)
-        {
-            dbprintlf(BLUE_FG "Waiting to receive...");
+/**
+ * @brief Keeps the rotator timer armed for the next paced byte while commands are queued.
+ *
+ */
+static void track_schedule_rotator(track_loop_t *tl, const struct timespec *next)
+{
+    if (rotator_busy(tl->global->rotator))
+    {
+        ev_timer_arm(tl->rotator_timer, next, 0);
+    }
+    else
+    {
+        ev_timer_arm(tl->rotator_timer, nullptr, 0);
+    }
+}
 
-            NetFrame *netframe = new NetFrame();
-            read_size = netframe->recvFrame(network_data);
+static void on_track_timer(int fd, uint32_t events, void *ctx)
+{
+    track_loop_t *tl = (track_loop_t *)ctx;
+    global_data_t *global = tl->global;
+    rt_loop_t *loop = tl->loop;
 
-            dbprintlf("Read %d bytes.", read_size);
+    if (ev_timer_read(fd) == 0)
+    {
+        return;
+    }
 
-            if (read_size >= 0)
-            {
-                dbprintlf("Received the following NetFrame:");
-                netframe->print();
-                netframe->printNetstat();
-
-                // Extract the payload into a buffer.
-                int payload_size = netframe->getPayloadSize();
-                unsigned char *payload = (unsigned char *)malloc(payload_size);
-                if (payload == nullptr)
-                {
-                    dbprintlf(FATAL "Memory for payload failed to allocate, packet lost.");
-                    continue;
-                }
-
-                if (netframe->retrievePayload(payload, payload_size) < 0)
-                {
-                    dbprintlf(RED_FG "Error retrieving data.");
-                    if (payload != nullptr)
-                    {
-                        free(payload);
-                        payload = nullptr;
-                    }
-                    continue;
-                }
-
-                switch (netframe->getType())
-                {
-                case NetType::TRACKING_COMMAND:
-                {
-                    dbprintlf(BLUE_FG "Received a tracking command.");
-
-                    double AzEl[2] = {0};
-                    netframe->retrievePayload((unsigned char *)AzEl, sizeof(AzEl));
-
-                    // dbprintlf(BLUE_FG "Setting AzEl to: %d, %d", AzEl[0], AzEl[1]);
-
-                    // aim_azimuth(global->connection, AzEl[0]);
-                    // global->AzEl[0] = AzEl[0];
-                    // aim_azimuth(global->connection, AzEl[1]);
-                    // global->AzEl[1] = AzEl[1];
-
-                    // Send our updated coordinates.
-                    NetFrame *network_frame = new NetFrame((unsigned char *)global->AzEl, sizeof(global->AzEl), NetType::TRACKING_DATA, NetVertex::CLIENT);
-                    network_frame->sendFrame(global->network_data);
-                    delete network_frame;
-
-                    break;
-                }
-                case NetType::ACK:
-                {
-                    break;
-                }
-                case NetType::NACK:
-                {
-                    break;
-                }
-                default:
-                {
-                    break;
-                }
-                }
-                if (payload != nullptr)
-                {
-                    free(payload);
-                    payload = nullptr;
-                }
-            }
-            else
-            {
-                break;
-            }
+    int skipped = rt_loop_tick(loop);
+    if (skipped > 0)
+    {
+        dbprintlf(RED_FG "Tracking cycle overran, skipped %d deadline(s).", skipped);
+    }
+    global->track_stats = loop->stats;
 
-            delete netframe;
-        }
-        if (read_size == -404)
+    if (loop->stats.cycles % (TRACK_STATS_INTERVAL * global->track_rate_hz) == 0)
+    {
+        dbprintlf(BLUE_FG "Loop jitter: %.3f ms mean, %.3f ms stddev, %.3f ms max | %" PRIu64 " overruns in %" PRIu64 " cycles", loop->stats.jitter_mean / 1e6, rt_loop_jitter_stddev(&loop->stats) / 1e6, loop->stats.jitter_max / 1e6, loop->stats.overruns, loop->stats.cycles);
+    }
+
+#if !defined(DISABLE_DEVICE)
+    if (global->rotator_feedback)
+    {
+        rotator_query(global->rotator);
+    }
+#endif
+    track_step(global, tl->state);
+    bool commanded = track_execute(global, tl->state);
+
+    track_snapshot_t snapshot;
+    track_snapshot(global, tl->state, loop->stats.cycles, &snapshot);
+    global->state = snapshot;
+    trackshm_publish(tl->shm, &snapshot);
+
+    if (tl->rec->header != nullptr)
+    {
+        flightrec_record_t record;
+        track_record(global, tl->state, &snapshot, &record);
+        flightrec_write(tl->rec, &record);
+    }
+
+    if (commanded) // any change, send over network
+    {
+        track_send_status(global);
+    }
+
+    track_schedule_rotator(tl, &global->rotator->next_byte);
+}
+
+static void on_rotator_timer(int fd, uint32_t events, void *ctx)
+{
+    track_loop_t *tl = (track_loop_t *)ctx;
+
+    if (ev_timer_read(fd) == 0)
+    {
+        return;
+    }
+
+    struct timespec next;
+    rotator_service(tl->global->rotator, &next);
+    track_schedule_rotator(tl, &next);
+}
+
+static void on_serial(int fd, uint32_t events, void *ctx)
+{
+    track_loop_t *tl = (track_loop_t *)ctx;
+    rotator_read(tl->global->rotator);
+}
+
+static void on_network(int fd, uint32_t events, void *ctx)
+{
+    track_loop_t *tl = (track_loop_t *)ctx;
+    global_data_t *global = tl->global;
+
+    // Drain a burst in one wake-up rather than one frame per trip around the loop.
+    int read_size = -1;
+    for (int i = 0; i < TRACK_RX_BATCH && !(events & (EPOLLERR | EPOLLHUP)); i++)
+    {
+        NetFrame netframe;
+        read_size = netframe.recvFrame(global->network_data);
+        if (read_size < 0)
         {
+            break;
         }
-        else if (errno == EAGAIN)
+        struct timespec received;
+        clock_gettime(CLOCK_MONOTONIC, &received);
+        dbprintlf("Read %d bytes.", read_size);
+        netstats_received(global->netstats, (int)netframe.getType(), read_size, &received);
+        track_handle_frame(global, tl->state, &netframe, &received);
+
+        int pending = 0;
+        if (ioctl(fd, FIONREAD, &pending) < 0 || pending <= 0)
         {
+            break;
         }
+    }
+
+    // An operator command goes out now rather than at the next tracking cycle.
+    track_schedule_rotator(tl, &global->rotator->next_byte);
+
+    if (events & (EPOLLERR | EPOLLHUP))
+    {
+        dbprintlf(RED_FG "Server connection on socket %d hung up.", fd);
+    }
+    else if (read_size < 0)
+    {
         erprintlf(errno);
     }
+    if (read_size < 0)
+    {
+        // Picked up again by on_housekeeping() once the polling thread has reconnected.
+        ev_remove(tl->ev, fd);
+        tl->net_fd = -1;
+    }
+}
 
-    network_data->recv_active = false;
+static void on_status_timer(int fd, uint32_t events, void *ctx)
+{
+    track_loop_t *tl = (track_loop_t *)ctx;
 
-    dbprintlf(FATAL "DANGER! NETWORK RECEIVE THREAD IS RETURNING!");
-    if (global->network_data->thread_status > 0)
+    if (ev_timer_read(fd) == 0)
     {
-        global->network_data->thread_status = 0;
+        return;
+    }
+
+    // Send our coordinates.
+    track_send_status(tl->global);
+}
+
+static void on_telem_timer(int fd, uint32_t events, void *ctx)
+{
+    track_loop_t *tl = (track_loop_t *)ctx;
+    track_state_t *state = tl->state;
+
+    if (ev_timer_read(fd) == 0)
+    {
+        return;
+    }
+
+    // Runs on the event loop, so the exception-free propagation; a sample that cannot be propagated is skipped.
+    DateTime tnow = simclock_now();
+    Eci eci;
+    if (state->target->FindPosition(tnow, eci) != SGP4::OK)
+    {
+        return;
+    }
+    CoordTopocentric look = state->dish->GetLookAngle(eci);
+    double cmd_az = state->cmd_az, cmd_el = state->cmd_el;
+    track_to_sky(&cmd_az, &cmd_el);
+
+    telem_sample_t sample;
+    sample.time_us = (tnow.Ticks() - UnixEpoch) / TicksPerMicrosecond;
+    sample.cmd_az = cmd_az;
+    sample.cmd_el = cmd_el;
+    sample.pred_az = look.azimuth DEG;
+    sample.pred_el = look.elevation DEG;
+    sample.range = look.range;
+    sample.range_rate = look.range_rate;
+    sample.phase = state->phase;
+    sample.reserved[0] = sample.reserved[1] = sample.reserved[2] = 0;
+
+    if (!telem_push(tl->telem, &sample))
+    {
+        return;
+    }
+
+    // A batch that cannot go out now is stale by the next one, drop it.
+    if (tl->global->network_data->connection_ready)
+    {
+        track_send_frame(tl->global, NetType::DATA, &tl->telem->frame, telem_size(tl->telem));
+    }
+    telem_next(tl->telem);
+}
+
+static void on_stats_timer(int fd, uint32_t events, void *ctx)
+{
+    track_loop_t *tl = (track_loop_t *)ctx;
+    global_data_t *global = tl->global;
+
+    if (ev_timer_read(fd) == 0)
+    {
+        return;
+    }
+
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    netstats_expire(global->netstats, &now);
+
+    netstats_report_t report;
+    netstats_report(global->netstats, &report);
+    dbprintlf(BLUE_FG "Link: %" PRIu64 "/%" PRIu64 " frames sent/received, %" PRIu64 " failed, %" PRIu64 " unacknowledged | ACK RTT %.2f ms mean, %.2f ms max", report.sent_frames, report.received_frames, report.failed, report.unacked, report.rtt_mean, report.rtt_max);
+
+    if (global->network_data->connection_ready)
+    {
+        track_send_frame(global, NetType::DATA, &report, sizeof(report));
+    }
+}
+
+static void on_stats_query(int fd, uint32_t events, void *ctx)
+{
+    track_loop_t *tl = (track_loop_t *)ctx;
+
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    netstats_expire(tl->global->netstats, &now);
+    netstats_serve(tl->global->netstats, fd);
+}
+
+/**
+ * @brief Applies global_data_t::catalog_path if it was modified since it was last read. Files ending in .csv or .kvn
+ * are read as OMM, others as TLE. A full pull is parsed on the event loop, only once per change of the file.
+ *
+ */
+static void track_reload_catalog(track_loop_t *tl)
+{
+    const char *path = tl->global->catalog_path;
+    struct stat st;
+    if (path == nullptr || stat(path, &st) < 0 ||
+        (st.st_mtim.tv_sec == tl->catalog_mtime.tv_sec && st.st_mtim.tv_nsec == tl->catalog_mtime.tv_nsec))
+    {
+        return;
+    }
+    tl->catalog_mtime = st.st_mtim;
+
+    std::ifstream file(path);
+    if (!file)
+    {
+        dbprintlf(RED_FG "Could not open catalog %s.", path);
+        return;
+    }
+
+    size_t len = strlen(path);
+    bool omm = len > 4 && (strcmp(path + len - 4, ".csv") == 0 || strcmp(path + len - 4, ".kvn") == 0);
+    if ((omm ? catalog_update_omm(tl->state->catalog, file) : catalog_update_tle(tl->state->catalog, file)) >= 0 &&
+        catalog_find(tl->state->catalog, tl->state->norad) == nullptr)
+    {
+        dbprintlf(YELLOW_FG "Catalog %s does not hold %u, tracking on its last elements.", path, tl->state->norad);
+    }
+}
+
+static void on_housekeeping(int fd, uint32_t events, void *ctx)
+{
+    track_loop_t *tl = (track_loop_t *)ctx;
+    NetDataClient *network_data = tl->global->network_data;
+
+    if (ev_timer_read(fd) == 0)
+    {
+        return;
+    }
+
+    // Tracking does not depend on the server link, only a shutdown request ends it.
+    if (tl->global->done)
+    {
+        tl->ev->running = false;
+        return;
+    }
+
+    track_reload_catalog(tl);
+
+    // Follow the socket the polling thread (re)connected.
+    int socket = network_data->connection_ready ? network_data->socket : -1;
+    if (socket != tl->net_fd)
+    {
+        if (tl->net_fd >= 0)
+        {
+            ev_remove(tl->ev, tl->net_fd);
+            tl->net_fd = -1;
+        }
+        if (socket >= 0 && ev_add(tl->ev, socket, EPOLLIN, on_network, tl) > 0)
+        {
+            tl->net_fd = socket;
+            dbprintlf(GREEN_FG "Listening on network socket %d.", socket);
+        }
     }
-    return nullptr;
 }
 
-void *track_status_thread(void *args)
+void *track_event_thread(void *args)
 {
-    dbprintlf(GREEN_FG "TRACK STATUS THREAD STARTING");
+    dbprintlf(GREEN_FG "TRACK EVENT THREAD STARTING");
 
     global_data_t *global = (global_data_t *)args;
-    NetDataClient *network_data = global->network_data;
 
-    while (network_data->thread_status > 0)
+    while (global->connection < 3 && !global->done)
     {
-        // Send our coordinates.
-        NetFrame *network_frame = new NetFrame((unsigned char *)global->AzEl, sizeof(global->AzEl), NetType::TRACKING_DATA, NetVertex::CLIENT);
-        network_frame->sendFrame(global->network_data);
-        delete network_frame;
+        // Open a connection to the dish controller.
+        global->connection = open_connection(global->devname);
 
-        usleep(10 SEC);
+        if (global->connection < 3)
+        {
+            dbprintlf(RED_FG "Device not found.");
+            usleep(5 SEC);
+        }
+    }
+    if (global->done)
+    {
+        return NULL;
+    }
+
+    // The simulated rotator starts parked and there is no bias controller to set.
+    if (global->sim == nullptr)
+    {
+        sleep(2);
+        if (global->resetAtInit)
+        {
+            aim_azimuth(global->connection, -AZIM_ADJ);
+            usleep(20000);
+            aim_elevation(global->connection, 90);
+            for (int i = 60; i > 0; i--)
+            {
+                dbprintlf(RED_FG "Init: Sleep remaining %d seconds", i);
+                sleep(1);
+            }
+        }
+
+        char biasctrl_status = 0;
+        if ((biasctrl_status = system("biasctrl -r") >> 8) < 0)
+        {
+            dbprintlf(FATAL "Could not reset bias controller, exiting, code %d", biasctrl_status);
+            exit(0);
+        }
+        if ((biasctrl_status = system("biasctrl -s -3.0") >> 8) < 0)
+        {
+            dbprintlf(FATAL "Could not reset bias voltage, exiting, code %d", biasctrl_status);
+            exit(0);
+        }
+    }
+
+    if (rotator_init(global->rotator, global->connection) < 0)
+    {
+        dbprintlf(FATAL "Could not start rotator writer, exiting.");
+        exit(0);
     }
 
-    dbprintlf(RED_BG "TRACK STATUS THREAD EXITING");
+    track_loop_t tl[1];
+    tl->global = global;
+    tl->net_fd = -1;
+    tl->catalog_mtime = {0, 0};
+    track_init(tl->state);
+    track_reload_catalog(tl);
+
+    track_snapshot_t snapshot;
+    track_snapshot(global, tl->state, 0, &snapshot);
+    global->state = snapshot;
+
+    if (trackshm_create(tl->shm, TRACKSHM_NAME) < 0)
+    {
+        dbprintlf(RED_FG "Could not publish tracking state in shared memory, continuing without it.");
+    }
+    tl->rec->header = nullptr;
+    if (global->flightrec_path != nullptr && flightrec_open(tl->rec, global->flightrec_path, FLIGHTREC_RECORDS) < 0)
+    {
+        dbprintlf(RED_FG "Could not open the flight recorder, continuing without it.");
+    }
+
+    if (rt_loop_init_period(tl->loop, simclock_wall_ns(1000000000LL / global->track_rate_hz)) < 0 || ev_loop_init(tl->ev) < 0)
+    {
+        dbprintlf(FATAL "Could not start tracking loop at %d Hz.", global->track_rate_hz);
+        exit(0);
+    }
+
+    tl->track_timer = ev_timer_create();
+    tl->rotator_timer = ev_timer_create();
+    tl->status_timer = ev_timer_create();
+    tl->housekeeping_timer = ev_timer_create();
+    tl->telem_timer = -1;
+    tl->stats_timer = ev_timer_create();
+
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    struct timespec stats_first = now;
+    stats_first.tv_sec += NETSTATS_INTERVAL;
+
+    // The tracking timer follows the rt_loop deadlines so rt_loop_tick() measures the timerfd wake-up latency.
+    // Status and telemetry stay on wall time in a simulation, the link should not see simulated rates.
+    if (tl->track_timer < 0 || tl->rotator_timer < 0 || tl->status_timer < 0 || tl->housekeeping_timer < 0 || tl->stats_timer < 0 ||
+        ev_timer_arm(tl->track_timer, &tl->loop->deadline, tl->loop->period) < 0 ||
+        ev_timer_arm(tl->status_timer, &now, TRACK_STATUS_INTERVAL * 1000000000LL) < 0 ||
+        ev_timer_arm(tl->housekeeping_timer, &now, TRACK_HOUSEKEEPING_INTERVAL * 1000000000LL) < 0 ||
+        ev_timer_arm(tl->stats_timer, &stats_first, NETSTATS_INTERVAL * 1000000000LL) < 0 ||
+        ev_add(tl->ev, tl->track_timer, EPOLLIN, on_track_timer, tl) < 0 ||
+        ev_add(tl->ev, tl->rotator_timer, EPOLLIN, on_rotator_timer, tl) < 0 ||
+        ev_add(tl->ev, tl->status_timer, EPOLLIN, on_status_timer, tl) < 0 ||
+        ev_add(tl->ev, tl->housekeeping_timer, EPOLLIN, on_housekeeping, tl) < 0 ||
+        ev_add(tl->ev, tl->stats_timer, EPOLLIN, on_stats_timer, tl) < 0)
+    {
+        dbprintlf(FATAL "Could not set up the event loop, exiting.");
+        exit(0);
+    }
+#if !defined(DISABLE_DEVICE)
+    ev_add(tl->ev, global->connection, EPOLLIN, on_serial, tl);
+#endif
+
+
+    netstats_init(global->netstats);
+    tl->stats_socket = netstats_listen(NETSTATS_SOCKET);
+    if (tl->stats_socket >= 0 && ev_add(tl->ev, tl->stats_socket, EPOLLIN, on_stats_query, tl) < 0)
+    {
+        close(tl->stats_socket);
+        tl->stats_socket = -1;
+    }
+    if (global->telem_rate_hz > 0 && telem_init(tl->telem, global->telem_rate_hz) > 0)
+    {
+        tl->telem_timer = ev_timer_create();
+        if (tl->telem_timer < 0 ||
+            ev_timer_arm(tl->telem_timer, &now, 1000000000LL / global->telem_rate_hz) < 0 ||
+            ev_add(tl->ev, tl->telem_timer, EPOLLIN, on_telem_timer, tl) < 0)
+        {
+            dbprintlf(RED_FG "Could not start telemetry, continuing without it.");
+        }
+    }
+    dbprintlf(GREEN_FG "Tracking at %d Hz, %.0fx real time.", global->track_rate_hz, simclock_scale());
+
+    ev_loop_run(tl->ev);
+
+    ev_loop_destroy(tl->ev);
+    close(tl->track_timer);
+    close(tl->rotator_timer);
+    close(tl->status_timer);
+    close(tl->housekeeping_timer);
+    close(tl->stats_timer);
+    if (tl->stats_socket >= 0)
+    {
+        close(tl->stats_socket);
+        unlink(NETSTATS_SOCKET);
+    }
+    if (tl->telem_timer >= 0)
+    {
+        close(tl->telem_timer);
+    }
+    trackshm_close(tl->shm, TRACKSHM_NAME);
+    flightrec_close(tl->rec);
+    delete tl->state->dish;
+    delete tl->state->target;
+    catalog_destroy(tl->state->catalog);
+    delete tl->state->catalog;
+
+    dbprintlf(RED_BG "TRACK EVENT THREAD EXITING");
+    // Lets the polling thread and main's reconnect loop finish.
     if (global->network_data->thread_status > 0)
     {
         global->network_data->thread_status = 0;
     }
+    return NULL;
 }
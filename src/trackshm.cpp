@@ -0,0 +1,141 @@
+/**
+ * @file trackshm.cpp
+ * @author Mit Bailey (mitbailey99@gmail.com)
+ * @brief
+ * @version See Git tags for version information.
+ * @date 2026.10.18
+ *
+ * @copyright Copyright (c) 2021
+ *
+ */
+
+#include <errno.h>
+#include <fcntl.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include "meb_debug.h"
+#include "trackshm.hpp"
+
+int trackshm_create(trackshm_t *shm, const char *name)
+{
+    shm->segment = nullptr;
+    shm->writer = true;
+
+    shm->fd = shm_open(name, O_RDWR | O_CREAT, 0644);
+    if (shm->fd < 0)
+    {
+        dbprintlf(RED_FG "Could not open shared memory %s, error %d.", name, errno);
+        return -1;
+    }
+    if (ftruncate(shm->fd, sizeof(trackshm_segment_t)) < 0)
+    {
+        dbprintlf(RED_FG "Could not size shared memory %s, error %d.", name, errno);
+        close(shm->fd);
+        return -1;
+    }
+
+    void *map = mmap(NULL, sizeof(trackshm_segment_t), PROT_READ | PROT_WRITE, MAP_SHARED, shm->fd, 0);
+    if (map == MAP_FAILED)
+    {
+        dbprintlf(RED_FG "Could not map shared memory %s, error %d.", name, errno);
+        close(shm->fd);
+        return -1;
+    }
+    shm->segment = (trackshm_segment_t *)map;
+
+    // A writer that died mid-publish leaves the sequence odd, which readers would retry on forever. Round it up to
+    // the next even value: a consistent state that no earlier read can match.
+    uint32_t sequence = shm->segment->lock.sequence.load(std::memory_order_relaxed);
+    shm->segment->lock.sequence.store((sequence + 1) & ~1u, std::memory_order_relaxed);
+
+    // Readers check the header before trusting the snapshot, so it goes last.
+    seqlock_write_begin(&shm->segment->lock);
+    memset(&shm->segment->snapshot, 0, sizeof(track_snapshot_t));
+    seqlock_write_end(&shm->segment->lock);
+    shm->segment->version = TRACKSHM_VERSION;
+    std::atomic_thread_fence(std::memory_order_release);
+    shm->segment->magic = TRACKSHM_MAGIC;
+
+    return 1;
+}
+
+int trackshm_attach(trackshm_t *shm, const char *name)
+{
+    shm->segment = nullptr;
+    shm->writer = false;
+
+    shm->fd = shm_open(name, O_RDONLY, 0);
+    if (shm->fd < 0)
+    {
+        return -1;
+    }
+
+    struct stat st;
+    if (fstat(shm->fd, &st) < 0 || st.st_size < (off_t)sizeof(trackshm_segment_t))
+    {
+        close(shm->fd);
+        return -1;
+    }
+
+    void *map = mmap(NULL, sizeof(trackshm_segment_t), PROT_READ, MAP_SHARED, shm->fd, 0);
+    if (map == MAP_FAILED)
+    {
+        close(shm->fd);
+        return -1;
+    }
+    shm->segment = (trackshm_segment_t *)map;
+
+    if (shm->segment->magic != TRACKSHM_MAGIC || shm->segment->version != TRACKSHM_VERSION)
+    {
+        trackshm_close(shm, name);
+        return -1;
+    }
+    return 1;
+}
+
+void trackshm_publish(trackshm_t *shm, const track_snapshot_t *snapshot)
+{
+    if (shm->segment == nullptr)
+    {
+        return;
+    }
+
+    seqlock_write_begin(&shm->segment->lock);
+    memcpy(&shm->segment->snapshot, snapshot, sizeof(track_snapshot_t));
+    seqlock_write_end(&shm->segment->lock);
+}
+
+bool trackshm_read(const trackshm_t *shm, track_snapshot_t *snapshot)
+{
+    if (shm->segment == nullptr)
+    {
+        return false;
+    }
+
+    for (int i = 0; i < TRACKSHM_READ_TRIES; i++)
+    {
+        uint32_t start = seqlock_read_begin(&shm->segment->lock);
+        memcpy(snapshot, &shm->segment->snapshot, sizeof(track_snapshot_t));
+        if (!seqlock_read_retry(&shm->segment->lock, start))
+        {
+            return true;
+        }
+    }
+    return false;
+}
+
+void trackshm_close(trackshm_t *shm, const char *name)
+{
+    if (shm->segment != nullptr)
+    {
+        munmap(shm->segment, sizeof(trackshm_segment_t));
+        shm->segment = nullptr;
+        close(shm->fd);
+    }
+    if (shm->writer)
+    {
+        shm_unlink(name);
+    }
+}
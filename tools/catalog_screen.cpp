@@ -0,0 +1,106 @@
+/**
+ * @file catalog_screen.cpp
+ * @author Mit Bailey (mitbailey99@gmail.com)
+ * @brief Lists which objects of a catalog pull rise above the station's horizon mask within a window.
+ * @version See Git tags for version information.
+ * @date 2026.10.18
+ *
+ * Loads a TLE or OMM catalog file with catalog.hpp, as the tracker's -c option does, and runs the two-body prefilter plus SGP4 refinement of screen.hpp.
+ * Usage:
+ *   catalog_screen.out [-f tle|omm] [-w hours] [-e min_elev] [-t unix_start] catalog_file
+ *
+ * @copyright Copyright (c) 2021
+ *
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <fstream>
+#include <vector>
+#include "meb_debug.h"
+#include "catalog.hpp"
+#include "screen.hpp"
+#include "track.hpp"
+
+#define SCREEN_WINDOW_HOURS 24 // default window
+
+int main(int argc, char *argv[])
+{
+    bool omm = false;
+    double window_hours = SCREEN_WINDOW_HOURS;
+    double min_elev = MIN_ELEV;
+    const char *start_arg = NULL;
+
+    int opt;
+    while ((opt = getopt(argc, argv, "f:w:e:t:")) != -1)
+    {
+        switch (opt)
+        {
+        case 'f':
+            if (strcmp(optarg, "omm") != 0 && strcmp(optarg, "tle") != 0)
+            {
+                dbprintlf(FATAL "Usage: %s [-f tle|omm] [-w hours] [-e min_elev] [-t unix_start] catalog_file", argv[0]);
+                return -1;
+            }
+            omm = strcmp(optarg, "omm") == 0;
+            break;
+        case 'w':
+            window_hours = atof(optarg);
+            break;
+        case 'e':
+            min_elev = atof(optarg);
+            break;
+        case 't':
+            start_arg = optarg;
+            break;
+        default:
+            dbprintlf(FATAL "Usage: %s [-f tle|omm] [-w hours] [-e min_elev] [-t unix_start] catalog_file", argv[0]);
+            return -1;
+        }
+    }
+    if (argc - optind != 1 || window_hours <= 0)
+    {
+        dbprintlf(FATAL "Usage: %s [-f tle|omm] [-w hours] [-e min_elev] [-t unix_start] catalog_file", argv[0]);
+        return -1;
+    }
+
+    std::ifstream file(argv[optind]);
+    if (!file)
+    {
+        dbprintlf(FATAL "Could not open %s.", argv[optind]);
+        return -1;
+    }
+
+    catalog_t catalog[1];
+    int loaded = omm ? catalog_update_omm(catalog, file) : catalog_update_tle(catalog, file);
+    if (loaded < 0)
+    {
+        dbprintlf(FATAL "No usable records in %s.", argv[optind]);
+        return -1;
+    }
+
+    DateTime start = DateTime::Now(true);
+    if (start_arg != NULL)
+    {
+        start = DateTime(UnixEpoch + (int64_t)atoll(start_arg) * TicksPerSecond);
+    }
+
+    Observer dish(GS_LAT, GS_LON, ELEV);
+    std::vector<unsigned int> visible;
+    if (screen_catalog(catalog, &dish, min_elev, start, window_hours * 60, visible) < 0)
+    {
+        catalog_destroy(catalog);
+        return -1;
+    }
+
+    printf("%zu of %zu objects rise above %.1f deg within %.1f h of %s:\n", visible.size(), catalog->entries.size(), min_elev, window_hours, start.ToString().c_str());
+    for (unsigned int norad : visible)
+    {
+        printf("%u\n", norad);
+    }
+
+    catalog_destroy(catalog);
+    return 0;
+}
@@ -0,0 +1,163 @@
+/**
+ * @file flightrec_csv.cpp
+ * @author Mit Bailey (mitbailey99@gmail.com)
+ * @brief Exports the tracker's flight recorder file to CSV, oldest record first.
+ * @version See Git tags for version information.
+ * @date 2026.10.18
+ *
+ * Safe to run while the tracker is recording. Usage:
+ *   flightrec_csv.out [-i flightrec.bin] [-o export.csv] [-n last_records]
+ *
+ * @copyright Copyright (c) 2021
+ *
+ */
+
+#include <inttypes.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include <unistd.h>
+#include "meb_debug.h"
+#include "flightrec.hpp"
+
+// In track_phase_t order, see track.hpp.
+static const char *phase_names[] = {"IDLE", "PREPOSITION", "PASS", "PARKING", "MANUAL"};
+static const char *gpio_names[] = {"IN", "OUT", "LOW", "HIGH"};
+
+static void print_utc(FILE *out, int64_t time_us)
+{
+    time_t seconds = time_us / 1000000;
+    struct tm utc;
+    gmtime_r(&seconds, &utc);
+    char date[32];
+    strftime(date, sizeof(date), "%Y-%m-%dT%H:%M:%S", &utc);
+    fprintf(out, "%s.%06ldZ", date, (long)(time_us % 1000000));
+}
+
+// Empty when the axis has not been commanded yet.
+static void print_mono(FILE *out, int64_t ns)
+{
+    if (ns != 0)
+    {
+        fprintf(out, "%.6f", ns / 1e9);
+    }
+}
+
+static void print_record(FILE *out, const flightrec_record_t *record)
+{
+    const track_snapshot_t *snapshot = &record->snapshot;
+
+    fprintf(out, "%" PRIu64 ",", record->sequence);
+    print_utc(out, snapshot->time_us);
+    fprintf(out, ",%.6f,%" PRIu64 ",%u,%s,", record->mono_ns / 1e9, snapshot->cycle, snapshot->norad, snapshot->phase < sizeof(phase_names) / sizeof(phase_names[0]) ? phase_names[snapshot->phase] : "UNKNOWN");
+    fprintf(out, "%.4f,%.4f,%.4f,%.6f,%.6f,%.6f,", record->eci_position[0], record->eci_position[1], record->eci_position[2], record->eci_velocity[0], record->eci_velocity[1], record->eci_velocity[2]);
+    fprintf(out, "%.3f,%.3f,%.6f,", snapshot->sat_az, snapshot->sat_el, snapshot->range_rate);
+    fprintf(out, "%.3f,%.3f,%.3f,%.3f,", record->cmd_az, record->cmd_el, snapshot->cmd_az, snapshot->cmd_el);
+    fprintf(out, "%.3f,%.3f,%d,%d,", snapshot->az, snapshot->el, (snapshot->flags & TRACKSHM_AZ_MEASURED) != 0, (snapshot->flags & TRACKSHM_EL_MEASURED) != 0);
+    for (int i = 0; i < 2; i++)
+    {
+        fprintf(out, "%u,", record->commands[i]);
+        print_mono(out, record->write_start_ns[i]);
+        fprintf(out, ",");
+        print_mono(out, record->write_end_ns[i]);
+        fprintf(out, ",");
+    }
+
+    int count = record->gpio_count < FLIGHTREC_GPIO_MAX ? record->gpio_count : FLIGHTREC_GPIO_MAX;
+    for (int i = 0; i < count; i++)
+    {
+        uint8_t kind = record->gpio[i].kind;
+        fprintf(out, "%s%u:%s", i > 0 ? ";" : "", record->gpio[i].pin, kind < sizeof(gpio_names) / sizeof(gpio_names[0]) ? gpio_names[kind] : "?");
+    }
+    fprintf(out, ",%u\n", record->gpio_dropped);
+}
+
+int main(int argc, char *argv[])
+{
+    const char *path = FLIGHTREC_PATH;
+    const char *out_path = NULL;
+    uint64_t last = 0;
+
+    int opt;
+    while ((opt = getopt(argc, argv, "i:o:n:")) != -1)
+    {
+        switch (opt)
+        {
+        case 'i':
+            path = optarg;
+            break;
+        case 'o':
+            out_path = optarg;
+            break;
+        case 'n':
+            last = strtoull(optarg, NULL, 10);
+            break;
+        default:
+            dbprintlf(FATAL "Usage: %s [-i flightrec.bin] [-o export.csv] [-n last_records]", argv[0]);
+            return -1;
+        }
+    }
+
+    flightrec_t rec[1];
+    if (flightrec_attach(rec, path) < 0)
+    {
+        dbprintlf(FATAL "%s is missing or not a version %d flight recorder file.", path, FLIGHTREC_VERSION);
+        return -1;
+    }
+
+    FILE *out = stdout;
+    if (out_path != NULL)
+    {
+        out = fopen(out_path, "w");
+        if (out == NULL)
+        {
+            dbprintlf(FATAL "Could not open %s.", out_path);
+            flightrec_close(rec);
+            return -1;
+        }
+    }
+
+    uint64_t first;
+    uint64_t count = flightrec_range(rec, &first);
+    if (last > 0 && last < count)
+    {
+        first += count - last;
+        count = last;
+    }
+
+    fprintf(out, "sequence,utc,mono_s,cycle,norad,phase,"
+                 "eci_x_km,eci_y_km,eci_z_km,eci_vx_km_s,eci_vy_km_s,eci_vz_km_s,"
+                 "sat_az,sat_el,range_rate_km_s,"
+                 "cmd_az_wrap,cmd_el_axis,cmd_az,cmd_el,"
+                 "dish_az,dish_el,az_measured,el_measured,"
+                 "az_commands,az_write_start_s,az_write_end_s,el_commands,el_write_start_s,el_write_end_s,"
+                 "gpio,gpio_dropped\n");
+
+    // The tracker may overwrite the oldest records while this runs, those are skipped.
+    uint64_t written = 0, skipped = 0;
+    for (uint64_t sequence = first; sequence < first + count; sequence++)
+    {
+        flightrec_record_t record;
+        if (!flightrec_read(rec, sequence, &record))
+        {
+            skipped++;
+            continue;
+        }
+        print_record(out, &record);
+        written++;
+    }
+
+    if (out != stdout)
+    {
+        fclose(out);
+    }
+    flightrec_close(rec);
+
+    fprintf(stderr, "Exported %" PRIu64 " records from %s", written, path);
+    if (skipped > 0)
+    {
+        fprintf(stderr, ", %" PRIu64 " overwritten while reading", skipped);
+    }
+    fprintf(stderr, ".\n");
+    return 0;
+}
@@ -0,0 +1,402 @@
+/**
+ * @file gs_standin.cpp
+ * @author Mit Bailey (mitbailey99@gmail.com)
+ * @brief Local stand-in for the ground station server: accepts the tracker, injects frames, records and times
+ * what comes back.
+ * @version See Git tags for version information.
+ * @date 2026.10.18
+ *
+ * The tracker's NetDataClient has to be pointed at this machine. A tracker that disconnects is waited for again, so
+ * its reconnect path can be exercised. Usage:
+ *   gs_standin.out [-c cmd_hz] [-a ack_hz] [-n nack_hz] [-A az] [-E el] [-d seconds] [-o record.csv]
+ *
+ * @copyright Copyright (c) 2021
+ *
+ */
+
+#include <arpa/inet.h>
+#include <inttypes.h>
+#include <math.h>
+#include <netinet/in.h>
+#include <poll.h>
+#include <signal.h>
+#include <stddef.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/socket.h>
+#include <time.h>
+#include <unistd.h>
+#include "meb_debug.h"
+#include "network.hpp"
+#include "telemetry.hpp"
+
+#define STANDIN_RTT_BINS 12 // powers of two from 1 ms
+
+typedef struct
+{
+    const char *name;
+    double rate; // Hz, 0 disables.
+    struct timespec next;
+    uint64_t sent;
+} injector_t;
+
+typedef struct
+{
+    uint64_t frames;
+    uint64_t bytes;
+} type_count_t;
+
+static volatile sig_atomic_t done = 0;
+
+static void on_signal(int sig)
+{
+    done = 1;
+}
+
+static double ts_seconds(const struct timespec *ts)
+{
+    return ts->tv_sec + ts->tv_nsec / 1e9;
+}
+
+static void injector_advance(injector_t *inj)
+{
+    double next = ts_seconds(&inj->next) + 1.0 / inj->rate;
+    inj->next.tv_sec = (time_t)next;
+    inj->next.tv_nsec = (next - inj->next.tv_sec) * 1e9;
+}
+
+static const char *type_name(NetType type)
+{
+    switch (type)
+    {
+    case NetType::POLL:
+        return "POLL";
+    case NetType::ACK:
+        return "ACK";
+    case NetType::NACK:
+        return "NACK";
+    case NetType::CONFIG:
+        return "CONFIG";
+    case NetType::DATA:
+        return "DATA";
+    case NetType::TRACKING_COMMAND:
+        return "TRACKING_COMMAND";
+    case NetType::TRACKING_DATA:
+        return "TRACKING_DATA";
+    default:
+        return "UNKNOWN";
+    }
+}
+
+static int type_index(NetType type)
+{
+    switch (type)
+    {
+    case NetType::POLL:
+        return 0;
+    case NetType::ACK:
+        return 1;
+    case NetType::NACK:
+        return 2;
+    case NetType::CONFIG:
+        return 3;
+    case NetType::DATA:
+        return 4;
+    case NetType::TRACKING_COMMAND:
+        return 5;
+    case NetType::TRACKING_DATA:
+        return 6;
+    default:
+        return 7;
+    }
+}
+
+static int listen_on(int port)
+{
+    int fd = socket(AF_INET, SOCK_STREAM, 0);
+    if (fd < 0)
+    {
+        return -1;
+    }
+
+    int one = 1;
+    setsockopt(fd, SOL_SOCKET, SO_REUSEADDR, &one, sizeof(one));
+
+    struct sockaddr_in addr;
+    memset(&addr, 0, sizeof(addr));
+    addr.sin_family = AF_INET;
+    addr.sin_addr.s_addr = htonl(INADDR_ANY);
+    addr.sin_port = htons(port);
+    if (bind(fd, (struct sockaddr *)&addr, sizeof(addr)) < 0 || listen(fd, 1) < 0)
+    {
+        close(fd);
+        return -1;
+    }
+    return fd;
+}
+
+int main(int argc, char *argv[])
+{
+    injector_t injectors[3] = {{"TRACKING_COMMAND", 0}, {"ACK", 0}, {"NACK", 0}};
+    double az = 180.0, el = 45.0;
+    double duration = 0;
+    const char *record_path = NULL;
+
+    int opt;
+    while ((opt = getopt(argc, argv, "c:a:n:A:E:d:o:")) != -1)
+    {
+        switch (opt)
+        {
+        case 'c':
+            injectors[0].rate = atof(optarg);
+            break;
+        case 'a':
+            injectors[1].rate = atof(optarg);
+            break;
+        case 'n':
+            injectors[2].rate = atof(optarg);
+            break;
+        case 'A':
+            az = atof(optarg);
+            break;
+        case 'E':
+            el = atof(optarg);
+            break;
+        case 'd':
+            duration = atof(optarg);
+            break;
+        case 'o':
+            record_path = optarg;
+            break;
+        default:
+            dbprintlf(FATAL "Usage: %s [-c cmd_hz] [-a ack_hz] [-n nack_hz] [-A az] [-E el] [-d seconds] [-o record.csv]", argv[0]);
+            return -1;
+        }
+    }
+
+    signal(SIGINT, on_signal);
+    signal(SIGPIPE, SIG_IGN);
+
+    FILE *record = NULL;
+    if (record_path != NULL)
+    {
+        record = fopen(record_path, "w");
+        if (record == NULL)
+        {
+            dbprintlf(FATAL "Could not open %s.", record_path);
+            return -1;
+        }
+        fprintf(record, "time,type,bytes,az,el,telem_sequence,telem_samples\n");
+    }
+
+    int listener = listen_on((int)NetPort::TRACK);
+    if (listener < 0)
+    {
+        dbprintlf(FATAL "Could not listen on port %d.", (int)NetPort::TRACK);
+        return -1;
+    }
+    dbprintlf(GREEN_FG "Waiting for the tracker on port %d.", (int)NetPort::TRACK);
+
+    int client = -1;
+    int connections = 0;
+    NetData link;
+    link.socket = -1;
+    link.connection_ready = false;
+
+    struct timespec start, now;
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    for (int i = 0; i < 3; i++)
+    {
+        injectors[i].next = start;
+    }
+
+    type_count_t received[8];
+    memset(received, 0, sizeof(received));
+    uint64_t rtt_bins[STANDIN_RTT_BINS];
+    memset(rtt_bins, 0, sizeof(rtt_bins));
+    uint64_t rtt_count = 0;
+    double rtt_sum = 0, rtt_max = 0;
+    bool awaiting = false; // A command is out and its status echo has not come back.
+    struct timespec command_sent = {0, 0};
+
+    while (!done)
+    {
+        clock_gettime(CLOCK_MONOTONIC, &now);
+        if (duration > 0 && ts_seconds(&now) - ts_seconds(&start) >= duration)
+        {
+            break;
+        }
+
+        // Between connections only wait for the tracker, nothing is injected.
+        if (client < 0)
+        {
+            struct pollfd lfd = {listener, POLLIN, 0};
+            if (poll(&lfd, 1, 100) <= 0)
+            {
+                continue;
+            }
+            client = accept(listener, NULL, NULL);
+            if (client < 0)
+            {
+                dbprintlf(RED_FG "Accept failed.");
+                continue;
+            }
+            link.socket = client;
+            link.connection_ready = true;
+            connections++;
+            dbprintlf(GREEN_FG "Tracker connected.");
+            continue;
+        }
+
+        // Inject whatever is due.
+        double wait = 0.1;
+        for (int i = 0; i < 3; i++)
+        {
+            injector_t *inj = &injectors[i];
+            if (inj->rate <= 0)
+            {
+                continue;
+            }
+            if (ts_seconds(&inj->next) <= ts_seconds(&now))
+            {
+                if (i == 0)
+                {
+                    double AzEl[2] = {az, el};
+                    NetFrame frame((unsigned char *)AzEl, sizeof(AzEl), NetType::TRACKING_COMMAND, NetVertex::TRACK);
+                    frame.sendFrame(&link);
+                    command_sent = now;
+                    awaiting = true;
+                }
+                else
+                {
+                    unsigned char unused = 0;
+                    NetFrame frame(&unused, sizeof(unused), i == 1 ? NetType::ACK : NetType::NACK, NetVertex::TRACK);
+                    frame.sendFrame(&link);
+                }
+                inj->sent++;
+                injector_advance(inj);
+            }
+            wait = fmin(wait, ts_seconds(&inj->next) - ts_seconds(&now));
+        }
+
+        struct pollfd pfd = {client, POLLIN, 0};
+        int ready = poll(&pfd, 1, wait > 0 ? (int)ceil(wait * 1e3) : 0);
+        if (ready <= 0)
+        {
+            continue;
+        }
+        int size = -1;
+        NetFrame frame;
+        if (pfd.revents & (POLLERR | POLLHUP))
+        {
+            dbprintlf(RED_FG "Tracker disconnected.");
+        }
+        else if ((size = frame.recvFrame(&link)) < 0)
+        {
+            dbprintlf(RED_FG "Receive failed, disconnecting.");
+        }
+        if (size < 0)
+        {
+            close(client);
+            client = -1;
+            link.socket = -1;
+            link.connection_ready = false;
+            awaiting = false;
+            dbprintlf(GREEN_FG "Waiting for the tracker to reconnect.");
+            continue;
+        }
+        clock_gettime(CLOCK_MONOTONIC, &now);
+
+        NetType type = frame.getType();
+        int payload_size = frame.getPayloadSize();
+        type_count_t *count = &received[type_index(type)];
+        count->frames++;
+        count->bytes += size;
+
+        alignas(double) unsigned char payload[0x200];
+        bool have_payload = payload_size > 0 && payload_size <= (int)sizeof(payload) && frame.retrievePayload(payload, sizeof(payload)) >= 0;
+
+        double rx_az = NAN, rx_el = NAN;
+        long telem_sequence = -1;
+        int telem_samples = 0;
+        if (type == NetType::TRACKING_DATA && have_payload && payload_size == 2 * sizeof(double))
+        {
+            rx_az = ((double *)payload)[0];
+            rx_el = ((double *)payload)[1];
+
+            // The tracker answers every command with a status frame.
+            if (awaiting)
+            {
+                double rtt = ts_seconds(&now) - ts_seconds(&command_sent);
+                int bin = 0;
+                while (bin < STANDIN_RTT_BINS - 1 && rtt * 1e3 >= (1 << (bin + 1)))
+                {
+                    bin++;
+                }
+                rtt_bins[bin]++;
+                rtt_count++;
+                rtt_sum += rtt;
+                rtt_max = fmax(rtt_max, rtt);
+                awaiting = false;
+            }
+        }
+        else if (type == NetType::DATA && have_payload && payload_size >= (int)offsetof(telem_frame_t, samples))
+        {
+            telem_frame_t *telem = (telem_frame_t *)payload;
+            if (telem->magic == TELEM_MAGIC)
+            {
+                telem_sequence = telem->sequence;
+                telem_samples = telem->count;
+            }
+        }
+        else if (type == NetType::POLL)
+        {
+            // Keep the client's polling thread satisfied.
+            unsigned char unused = 0;
+            NetFrame reply(&unused, sizeof(unused), NetType::POLL, NetVertex::TRACK);
+            reply.sendFrame(&link);
+        }
+
+        if (record != NULL)
+        {
+            fprintf(record, "%.6f,%s,%d,%.2f,%.2f,%ld,%d\n", ts_seconds(&now) - ts_seconds(&start), type_name(type), size, rx_az, rx_el, telem_sequence, telem_samples);
+        }
+    }
+
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    double elapsed = ts_seconds(&now) - ts_seconds(&start);
+
+    printf("Ran %.1f s over %d connection(s). Injected %" PRIu64 " TRACKING_COMMAND, %" PRIu64 " ACK, %" PRIu64 " NACK.\n", elapsed, connections, injectors[0].sent, injectors[1].sent, injectors[2].sent);
+    static const NetType types[] = {NetType::POLL, NetType::ACK, NetType::NACK, NetType::CONFIG, NetType::DATA, NetType::TRACKING_COMMAND, NetType::TRACKING_DATA};
+    for (NetType type : types)
+    {
+        type_count_t *count = &received[type_index(type)];
+        if (count->frames > 0)
+        {
+            printf("  %-16s %8" PRIu64 " frames %10" PRIu64 " bytes  %8.2f frames/s\n", type_name(type), count->frames, count->bytes, count->frames / elapsed);
+        }
+    }
+    if (rtt_count > 0)
+    {
+        printf("Command to status round trip: %.2f ms mean, %.2f ms max over %" PRIu64 ".\n", rtt_sum / rtt_count * 1e3, rtt_max * 1e3, rtt_count);
+        for (int i = 0; i < STANDIN_RTT_BINS; i++)
+        {
+            if (rtt_bins[i] > 0)
+            {
+                printf("  %s%5d ms %8" PRIu64 "\n", i == STANDIN_RTT_BINS - 1 ? ">=" : "< ", 1 << (i + 1 == STANDIN_RTT_BINS ? i : i + 1), rtt_bins[i]);
+            }
+        }
+    }
+
+    if (record != NULL)
+    {
+        fclose(record);
+    }
+    if (client >= 0)
+    {
+        close(client);
+    }
+    close(listener);
+    return 0;
+}